@@ -0,0 +1,179 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE 1
+#endif
+
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fat/fat_helper.h"
+#include "kernel/kernel.h"
+#include "kernel/kernel_system.h"
+#include "util/PCBDeque.h"
+#include "util/PIDDeque.h"
+#include "util/globals.h"
+#include "util/os_errors.h"
+
+// Global Variables
+int fs_fd = -1;          // File Descriptor for FAT
+uint16_t* fat = NULL;    // FAT
+global_fdt g_fdt[1024];  // Global File Descriptor Table
+int g_counter = 0;
+pid_t fgJob = 0;
+bool logged_out = false;
+pid_t plus_pid = -1;
+pid_t currentJob = 0;
+int P_ERRNO = 0;
+PCBDeque* PCBList;
+PIDDeque* priorityList[MAX_PRIORITY_LEVELS + 1];
+pid_t pidCount = 0;
+int ticks;
+char* logFileName;
+int logfd;
+TerminalHistory* curr_history;
+
+// A file system of 8 FAT blocks of 4096 bytes, as "mkfs NAME 8 4" makes it
+#define FAT_BLOCKS 8
+#define BLOCK_SIZE 4096
+#define FILE_SIZE (4 << 20)
+#define CHUNK 4096
+
+// Passes over each chunk after it is read, standing in for real processing
+static const int work_passes[] = {0, 1, 4};
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Makes and mounts an empty file system in a temporary host file
+static void make_fs(char* path) {
+  int fd = mkstemp(path);
+  int fat_size = FAT_BLOCKS * BLOCK_SIZE;
+  uint16_t* table = calloc(fat_size / 2, sizeof(uint16_t));
+  table[0] = (FAT_BLOCKS << 8) | 4;
+  table[1] = 0xFFFF;
+  if (fd == -1 || write(fd, table, fat_size) != fat_size ||
+      ftruncate(fd, fat_size + BLOCK_SIZE * (fat_size / 2 - 1)) == -1) {
+    perror("aio_bench: making the file system");
+    exit(EXIT_FAILURE);
+  }
+  free(table);
+  close(fd);
+  int num_blocks;
+  int block_size;
+  if (mount(path, &num_blocks, &block_size) == -1) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+static uint64_t process(const char* chunk, int len, int passes) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < len; i++) {
+      hash = (hash ^ (uint8_t)chunk[i]) * 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+
+// Waits for a ticket without a scheduler to block in: s_poll until the
+// operation is done, giving the host CPU to the I/O thread meanwhile
+static int await_spinning(int ticket) {
+  p_pollfd pfd = {.fd = ticket, .events = P_POLLIN | P_POLLAIO};
+  while (s_poll(&pfd, 1, 0) == 0) {
+    sched_yield();
+  }
+  return s_await(ticket);
+}
+
+// Reads the whole file in CHUNK-byte pieces, processing each, with s_read or
+// reading the next piece with s_aread while processing this one. Returns the
+// checksum of what was read.
+static uint64_t bench_read(int passes, bool async) {
+  int fd = s_open("data", F_READ);
+  static char buffers[2][CHUNK];
+  uint64_t checksum = 0;
+  long total = 0;
+
+  uint64_t start = now_ns();
+  if (async) {
+    int ticket = s_aread(fd, CHUNK, buffers[0]);
+    for (int curr = 0;; curr = 1 - curr) {
+      int len = await_spinning(ticket);
+      if (len <= 0) {
+        break;
+      }
+      ticket = s_aread(fd, CHUNK, buffers[1 - curr]);
+      checksum += process(buffers[curr], len, passes);
+      total += len;
+    }
+  } else {
+    int len;
+    while ((len = s_read(fd, CHUNK, buffers[0])) > 0) {
+      checksum += process(buffers[0], len, passes);
+      total += len;
+    }
+  }
+  uint64_t elapsed = now_ns() - start;
+  s_close(fd);
+
+  if (total != FILE_SIZE) {
+    fprintf(stderr, "aio_bench: read %ld of %d bytes\n", total, FILE_SIZE);
+    exit(EXIT_FAILURE);
+  }
+  printf(
+      "{\"bench\":\"aio_read\",\"async\":%s,\"chunk_bytes\":%d,"
+      "\"work_passes\":%d,\"us_per_chunk\":%.2f}\n",
+      async ? "true" : "false", CHUNK, passes,
+      (double)elapsed / (FILE_SIZE / CHUNK) / 1000);
+  fflush(stdout);
+  return checksum;
+}
+
+int main(int argc, char* argv[]) {
+  char path[] = "/tmp/aio_bench.XXXXXX";
+  make_fs(path);
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* proc = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                            "reader", false, NULL);
+  currentJob = proc->pid;
+
+  // Fill the file through the write path, then check async reads see it all
+  int fd = s_open("data", F_WRITE);
+  static char chunk[CHUNK];
+  for (int off = 0; off < FILE_SIZE; off += CHUNK) {
+    for (int i = 0; i < CHUNK; i++) {
+      chunk[i] = (char)((off + i) * 31);
+    }
+    if (s_write(fd, chunk, CHUNK) != CHUNK) {
+      fprintf(stderr, "aio_bench: writing the file failed\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  s_close(fd);
+
+  for (int i = 0; i < sizeof(work_passes) / sizeof(work_passes[0]); i++) {
+    if (bench_read(work_passes[i], false) != bench_read(work_passes[i], true)) {
+      fprintf(stderr, "aio_bench: async reads returned different data\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  k_free_lists();
+  munmap(fat, FAT_BLOCKS * BLOCK_SIZE);
+  close(fs_fd);
+  unlink(path);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,250 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE 1
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fat/fat_helper.h"
+#include "util/PCBDeque.h"
+#include "util/PIDDeque.h"
+#include "util/PIDIndex.h"
+#include "util/RingDeque.h"
+#include "util/globals.h"
+
+// Global Variables
+int fs_fd = -1;          // File Descriptor for FAT
+uint16_t* fat = NULL;    // FAT
+global_fdt g_fdt[1024];  // Global File Descriptor Table
+int g_counter = 0;
+pid_t fgJob = 0;
+bool logged_out = false;
+pid_t plus_pid = -1;
+pid_t currentJob = 0;
+int P_ERRNO = 0;
+PCBDeque* PCBList;
+PIDDeque* priorityList[MAX_PRIORITY_LEVELS + 1];
+pid_t pidCount = 0;
+int ticks;
+char* logFileName;
+int logfd;
+TerminalHistory* curr_history;
+
+#define OPS 1000000
+
+static const int pid_counts[] = {10, 100, 1000, 10000};
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t rng_state;
+
+static uint32_t next_rand() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+// The deques before RingDeque.h, for comparison: a doubly linked list with a
+// node allocated per push and a PID Index from each PID to its node
+typedef struct list_node {
+  pid_t pid;
+  struct list_node* next;
+  struct list_node* prev;
+} list_node;
+
+typedef struct list_deque {
+  list_node* front;
+  list_node* back;
+  PIDIndex* index;
+} list_deque;
+
+static void* list_allocate() {
+  list_deque* deque = calloc(1, sizeof(list_deque));
+  deque->index = PIDIndex_Allocate();
+  return deque;
+}
+
+static void list_unlink(list_deque* deque, list_node* node) {
+  if (node->prev != NULL) {
+    node->prev->next = node->next;
+  } else {
+    deque->front = node->next;
+  }
+  if (node->next != NULL) {
+    node->next->prev = node->prev;
+  } else {
+    deque->back = node->prev;
+  }
+  PIDIndex_Remove(deque->index, node->pid);
+  free(node);
+}
+
+static void list_push_back(void* d, pid_t pid) {
+  list_deque* deque = d;
+  list_node* node = malloc(sizeof(list_node));
+  *node = (list_node){.pid = pid, .prev = deque->back};
+  if (deque->back != NULL) {
+    deque->back->next = node;
+  } else {
+    deque->front = node;
+  }
+  deque->back = node;
+  PIDIndex_Put(deque->index, pid, node);
+}
+
+static bool list_pop_front(void* d, pid_t* pid) {
+  list_deque* deque = d;
+  if (deque->front == NULL) {
+    return false;
+  }
+  *pid = deque->front->pid;
+  list_unlink(deque, deque->front);
+  return true;
+}
+
+static bool list_remove(void* d, pid_t pid) {
+  list_deque* deque = d;
+  list_node* node = PIDIndex_Get(deque->index, pid);
+  if (node == NULL) {
+    return false;
+  }
+  list_unlink(deque, node);
+  return true;
+}
+
+static void list_free(void* d) {
+  pid_t pid;
+  while (list_pop_front(d, &pid)) {
+  }
+  PIDIndex_Free(((list_deque*)d)->index);
+  free(d);
+}
+
+// A ring deque without the PID Index, which removes by walking the deque
+#define PID_KEY(pid) (pid)
+RING_DEQUE_DECLARE(ScanDeque, pid_t)
+RING_DEQUE_DEFINE(ScanDeque, pid_t, -1, PID_KEY, 0)
+
+static void* ring_allocate() {
+  return PIDDeque_Allocate();
+}
+static void ring_push_back(void* d, pid_t pid) {
+  PIDDeque_Push_Back(d, pid);
+}
+static bool ring_pop_front(void* d, pid_t* pid) {
+  return PIDDeque_Pop_Front(d, pid);
+}
+static bool ring_remove(void* d, pid_t pid) {
+  return PIDDeque_Remove(d, pid, NULL);
+}
+static void ring_free(void* d) {
+  PIDDeque_Free(d);
+}
+
+static void* scan_allocate() {
+  return ScanDeque_Allocate();
+}
+static void scan_push_back(void* d, pid_t pid) {
+  ScanDeque_Push_Back(d, pid);
+}
+static bool scan_pop_front(void* d, pid_t* pid) {
+  return ScanDeque_Pop_Front(d, pid);
+}
+static bool scan_remove(void* d, pid_t pid) {
+  return ScanDeque_Remove(d, pid, NULL);
+}
+static void scan_free(void* d) {
+  ScanDeque_Free(d);
+}
+
+typedef struct deque_impl {
+  const char* name;
+  void* (*allocate)(void);
+  void (*push_back)(void*, pid_t);
+  bool (*pop_front)(void*, pid_t*);
+  bool (*remove)(void*, pid_t);
+  void (*free)(void*);
+} deque_impl;
+
+static const deque_impl impls[] = {
+    {"linked", list_allocate, list_push_back, list_pop_front, list_remove,
+     list_free},
+    {"ring", ring_allocate, ring_push_back, ring_pop_front, ring_remove,
+     ring_free},
+    {"ring_scan", scan_allocate, scan_push_back, scan_pop_front, scan_remove,
+     scan_free},
+};
+
+// Runs OPS operations of a trace against n PIDs and prints the time per op.
+// rotate: the scheduler popping the front job and queueing it at the back.
+// sleep_wake: a random job leaving the queue from wherever it is (blocking,
+// being stopped or exiting) and a random sleeping job being queued at the back,
+// with a rotation between them
+static void bench_trace(const deque_impl* impl, const char* trace, int n) {
+  void* deque = impl->allocate();
+  bool* queued = calloc(n, sizeof(bool));
+  for (pid_t pid = 0; pid < n; pid++) {
+    impl->push_back(deque, pid);
+    queued[pid] = true;
+  }
+  bool sleep_wake = trace[0] == 's';
+  rng_state = 2463534242u;
+
+  uint64_t start = now_ns();
+  for (int i = 0; i < OPS; i++) {
+    pid_t pid;
+    if (sleep_wake && i % 2 == 1) {
+      pid = next_rand() % n;
+      if (queued[pid]) {
+        impl->remove(deque, pid);
+      } else {
+        impl->push_back(deque, pid);
+      }
+      queued[pid] = !queued[pid];
+    } else if (impl->pop_front(deque, &pid)) {
+      impl->push_back(deque, pid);
+    }
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  printf(
+      "{\"bench\":\"deque\",\"trace\":\"%s\",\"impl\":\"%s\",\"pids\":%d,"
+      "\"ops\":%d,\"ns_per_op\":%.1f}\n",
+      trace, impl->name, n, OPS, (double)elapsed / OPS);
+  fflush(stdout);
+  impl->free(deque);
+  free(queued);
+}
+
+/**
+ * @brief Compares the ring deque the kernel uses, with and without its PID
+ * Index, against the linked deque it replaced on traces of run queue
+ * operations, printing one JSON object per trace, deque and number of PIDs.
+ *
+ * Example Usage: ./bin/deque_bench
+ */
+int main(int argc, char* argv[]) {
+  int num_impls = sizeof(impls) / sizeof(impls[0]);
+  int num_counts = sizeof(pid_counts) / sizeof(pid_counts[0]);
+  const char* traces[] = {"rotate", "sleep_wake"};
+  for (int t = 0; t < 2; t++) {
+    for (int i = 0; i < num_counts; i++) {
+      for (int j = 0; j < num_impls; j++) {
+        bench_trace(&impls[j], traces[t], pid_counts[i]);
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,225 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE 1
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fat/fat_helper.h"
+#include "kernel/kernel.h"
+#include "kernel/kernel_system.h"
+#include "util/PCBDeque.h"
+#include "util/PIDDeque.h"
+#include "util/globals.h"
+#include "util/os_errors.h"
+
+// Global Variables
+int fs_fd = -1;          // File Descriptor for FAT
+uint16_t* fat = NULL;    // FAT
+global_fdt g_fdt[1024];  // Global File Descriptor Table
+int g_counter = 0;
+pid_t fgJob = 0;
+bool logged_out = false;
+pid_t plus_pid = -1;
+pid_t currentJob = 0;
+int P_ERRNO = 0;
+PCBDeque* PCBList;
+PIDDeque* priorityList[MAX_PRIORITY_LEVELS + 1];
+pid_t pidCount = 0;
+int ticks;
+char* logFileName;
+int logfd;
+TerminalHistory* curr_history;
+
+#define MESSAGES (1 << 22)
+#define MESSAGE_SIZE 16
+#define CAPACITY 1024
+#define MAX_BATCH 256
+#define SENDERS 2
+
+static const int batch_sizes[] = {1, 8, 64, 256};
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Moves MESSAGES messages from a producer to a consumer process through one
+// queue, batch messages per call. The two take turns as the current job the
+// way the scheduler would switch between them, the producer filling the
+// queue and the consumer draining it, so no call ever blocks.
+static void bench_pingpong(int batch) {
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* producer = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                                "producer", false, NULL);
+  pcb* consumer = k_proc_create(producer, no_thread, STDIN_FILENO,
+                                STDOUT_FILENO, "consumer", false, NULL);
+  int mq = s_mq_open("bench", CAPACITY, true);
+
+  static char out[MAX_BATCH][MESSAGE_SIZE];
+  static char in[MAX_BATCH][MESSAGE_SIZE];
+  mq_msg sends[MAX_BATCH];
+  mq_msg recvs[MAX_BATCH];
+  for (int i = 0; i < batch; i++) {
+    sends[i] = (mq_msg){.data = out[i], .len = MESSAGE_SIZE};
+  }
+
+  uint64_t checksum = 0;
+  long sent = 0;
+  long received = 0;
+  uint64_t start = now_ns();
+  while (received < MESSAGES) {
+    currentJob = producer->pid;
+    while (sent < MESSAGES) {
+      int n = MESSAGES - sent < batch ? MESSAGES - sent : batch;
+      for (int i = 0; i < n; i++) {
+        *(long*)out[i] = sent + i;
+      }
+      int res = s_mq_send_batch(mq, sends, n, true);
+      if (res == 0) {
+        break;
+      }
+      sent += res;
+    }
+    currentJob = consumer->pid;
+    int res;
+    do {
+      for (int i = 0; i < batch; i++) {
+        recvs[i] = (mq_msg){.data = in[i], .len = MESSAGE_SIZE};
+      }
+      res = s_mq_recv_batch(mq, recvs, batch, true);
+      for (int i = 0; i < res; i++) {
+        checksum += *(long*)in[i];
+      }
+      received += res;
+    } while (res > 0);
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  uint64_t expected = (uint64_t)MESSAGES * (MESSAGES - 1) / 2;
+  if (checksum != expected) {
+    fprintf(stderr, "mq_bench: messages were lost or reordered\n");
+    exit(EXIT_FAILURE);
+  }
+  printf(
+      "{\"bench\":\"mq\",\"batch\":%d,\"message_bytes\":%d,\"messages\":%d,"
+      "\"ns_per_msg\":%.1f,\"msgs_per_sec\":%.0f}\n",
+      batch, MESSAGE_SIZE, MESSAGES, (double)elapsed / MESSAGES,
+      MESSAGES * 1e9 / elapsed);
+  fflush(stdout);
+
+  s_mq_destroy(mq);
+  k_free_lists();
+  pidCount = 0;
+}
+
+typedef struct sender_args {
+  int mq;
+  int id;
+  int batch;
+} sender_args;
+
+// Sends MESSAGES / SENDERS messages numbered from 0, each tagged with the
+// sender's id, retrying whenever the queue is full
+static void* sender_main(void* arg) {
+  sender_args* args = arg;
+  long out[MAX_BATCH][2];
+  mq_msg sends[MAX_BATCH];
+  long sent = 0;
+  while (sent < MESSAGES / SENDERS) {
+    int n = MESSAGES / SENDERS - sent < args->batch ? MESSAGES / SENDERS - sent
+                                                    : args->batch;
+    for (int i = 0; i < n; i++) {
+      out[i][0] = args->id;
+      out[i][1] = sent + i;
+      sends[i] = (mq_msg){.data = out[i], .len = MESSAGE_SIZE};
+    }
+    int res = s_mq_send_batch(args->mq, sends, n, true);
+    if (res == 0) {
+      sched_yield();
+    }
+    sent += res;
+  }
+  return NULL;
+}
+
+// Moves MESSAGES messages from SENDERS host threads sending at once to one
+// consumer, batch messages per call, so the senders race to claim slots the
+// way processes suspended mid-send by the scheduler would. Each sender's
+// messages must arrive once each and in the order it sent them.
+static void bench_senders(int batch) {
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* consumer = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                                "consumer", false, NULL);
+  currentJob = consumer->pid;
+  int mq = s_mq_open("bench", CAPACITY, true);
+
+  uint64_t start = now_ns();
+  pthread_t threads[SENDERS];
+  sender_args args[SENDERS];
+  for (int i = 0; i < SENDERS; i++) {
+    args[i] = (sender_args){.mq = mq, .id = i, .batch = batch};
+    pthread_create(&threads[i], NULL, sender_main, &args[i]);
+  }
+
+  long in[MAX_BATCH][2];
+  mq_msg recvs[MAX_BATCH];
+  long next[SENDERS] = {0};
+  long received = 0;
+  while (received < MESSAGES) {
+    for (int i = 0; i < batch; i++) {
+      recvs[i] = (mq_msg){.data = in[i], .len = MESSAGE_SIZE};
+    }
+    int res = s_mq_recv_batch(mq, recvs, batch, true);
+    if (res == 0) {
+      sched_yield();
+    }
+    for (int i = 0; i < res; i++) {
+      long id = in[i][0];
+      if (id < 0 || id >= SENDERS || in[i][1] != next[id]) {
+        fprintf(stderr, "mq_bench: messages were lost or reordered\n");
+        exit(EXIT_FAILURE);
+      }
+      next[id]++;
+    }
+    received += res;
+  }
+  for (int i = 0; i < SENDERS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  printf(
+      "{\"bench\":\"mq_senders\",\"senders\":%d,\"batch\":%d,"
+      "\"message_bytes\":%d,\"messages\":%d,\"ns_per_msg\":%.1f,"
+      "\"msgs_per_sec\":%.0f}\n",
+      SENDERS, batch, MESSAGE_SIZE, MESSAGES, (double)elapsed / MESSAGES,
+      MESSAGES * 1e9 / elapsed);
+  fflush(stdout);
+
+  s_mq_destroy(mq);
+  k_free_lists();
+  pidCount = 0;
+}
+
+int main(int argc, char* argv[]) {
+  for (int i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++) {
+    bench_pingpong(batch_sizes[i]);
+  }
+  for (int i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++) {
+    bench_senders(batch_sizes[i]);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+#!/bin/bash
+# Runs the scheduler simulator (make sim) over a set of workload mixes and
+# process counts. Prints one JSON object per run.
+#
+# Usage: bench/sched_bench.sh [path to pennos-sim]
+set -e
+
+SIM=${1:-./bin/pennos-sim}
+SEED=${SEED:-1}
+
+run() {
+  local bench=$1 name=$2 ticks=$3
+  shift 3
+  local result
+  result=$("$SIM" -s "$SEED" -t "$ticks" "$@")
+  printf '{"bench":"%s","name":"%s","result":%s}\n' "$bench" "$name" "$result"
+}
+
+# CPU shares against the 9:6:4 target (or the weights given with -p)
+run ratio busy 100000 -w cpu:1:0 -w cpu:1:1 -w cpu:1:2
+run ratio busy-many 100000 -w cpu:4:0 -w cpu:4:1 -w cpu:4:2
+run ratio busy-0-1 100000 -w cpu:1:0 -w cpu:1:1
+run ratio busy-1-2 100000 -w cpu:1:1 -w cpu:1:2
+run ratio busy-0-2 100000 -w cpu:1:0 -w cpu:1:2
+run ratio busy-sleep 100000 -w cpu:2:0 -w cpu:2:1 -w cpu:2:2 -w io:4:1:1
+run ratio io-bound 100000 -w io:4:0:2 -w io:4:1:2 -w io:4:2:2 -w cpu:1:2
+run ratio churn 100000 -w cpu:1:0 -w short:4:1:3 -w short:4:2:3
+run ratio five-levels 100000 -p 16,8,4,2,1 -w cpu:1:0 -w cpu:1:1 \
+  -w cpu:1:2 -w cpu:1:3 -w cpu:1:4
+
+# Per-tick scheduler overhead as the number of processes grows
+for n in 10 100 1000 10000; do
+  per_level=$(((n + 2) / 3))
+  run overhead "procs-$n" 20000 -w "cpu:$per_level:0" -w "cpu:$per_level:1" \
+    -w "cpu:$per_level:2"
+done
+
+# Short-window fairness and per-tick cost of the lottery against cfs
+for policy in lottery cfs; do
+  run fairness "busy-$policy" 100000 -S "$policy" -w cpu:1:0 -w cpu:1:1 \
+    -w cpu:1:2
+  run fairness "even-$policy" 100000 -S "$policy" -p 1,1 -w cpu:1:0 \
+    -w cpu:1:1
+  run fairness "busy-sleep-$policy" 100000 -S "$policy" -w cpu:2:0 \
+    -w cpu:2:1 -w cpu:2:2 -w io:4:1:1
+  run fairness "many-$policy" 100000 -S "$policy" -w cpu:4:0 -w cpu:4:1 \
+    -w cpu:4:2
+  run overhead "procs-10000-$policy" 20000 -S "$policy" -w cpu:3334:0 \
+    -w cpu:3334:1 -w cpu:3334:2
+done
+
+# Dispatch latency of low-priority jobs with and without aging
+for aging in 0 10 5; do
+  run aging "flood-a$aging" 100000 -a "$aging" -w cpu:50:0 -w cpu:2:2
+  run aging "mixed-a$aging" 100000 -a "$aging" -w cpu:1:0 -w cpu:1:1 \
+    -w cpu:1:2
+done
+
+# Deadline misses of real-time jobs near the utilisation cap, and the share
+# the best-effort levels keep of what is left
+run realtime rt-light 100000 -r 10:3 -w cpu:1:0 -w cpu:1:1 -w cpu:1:2
+run realtime rt-near-cap 100000 -r 10:3 -r 20:4 -r 50:10 -w cpu:1:0 \
+  -w cpu:1:2
+run realtime rt-many 100000 -r 100:2:40 -w cpu:2:0 -w io:4:1:1
+run realtime rt-cfs 100000 -S cfs -r 10:3 -r 20:4 -w cpu:2:0 -w cpu:2:2
+
+# CPU split between a tenant with one job and a noisy tenant with 20: without
+# groups (per job, with -v), with equal shares, and with the noisy tenant's
+# quota at 2 ticks in 10
+run groups noisy-none 100000 -v -w cpu:1:1 -w cpu:20:1
+run groups noisy-shares 100000 -g 1024 -w cpu:1:1 -g 1024 -w cpu:20:1
+run groups noisy-quota 100000 -g 1024 -w cpu:1:1 -g 1024:2:10 -w cpu:20:1
+run groups noisy-cfs 100000 -S cfs -g 1024 -w cpu:1:1 -g 1024 -w cpu:20:1
+run groups mixed-levels 100000 -g 2048 -w cpu:1:0 -w io:2:2:2 -g 1024 \
+  -w cpu:10:0
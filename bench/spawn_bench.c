@@ -0,0 +1,317 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE 1
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fat/fat_helper.h"
+#include "kernel/kernel.h"
+#include "kernel/kernel_system.h"
+#include "kernel/pidmap.h"
+#include "util/PCBDeque.h"
+#include "util/PIDDeque.h"
+#include "util/globals.h"
+#include "util/os_errors.h"
+
+// Global Variables
+int fs_fd = -1;          // File Descriptor for FAT
+uint16_t* fat = NULL;    // FAT
+global_fdt g_fdt[1024];  // Global File Descriptor Table
+int g_counter = 0;
+pid_t fgJob = 0;
+bool logged_out = false;
+pid_t plus_pid = -1;
+pid_t currentJob = 0;
+int P_ERRNO = 0;
+
+// Declared as global variable across files
+PCBDeque* PCBList;
+// 0 -> priority_zero, ..., INACTIVE_QUEUE -> inactive
+PIDDeque* priorityList[MAX_PRIORITY_LEVELS + 1];
+pid_t pidCount = 0;         // global variable which assigns PID to new process,
+                            // incremented by one each time
+
+int ticks;
+char* logFileName;
+int logfd;
+TerminalHistory* curr_history;
+
+#define ITERATIONS 2000
+// Enough create/exit/reap rounds to wrap around the default PID space 4 times
+#define CHURN_ITERATIONS (4 * PID_MAX_DEFAULT)
+
+static const int process_counts[] = {10, 100, 1000, 10000};
+
+static void* noop(void* arg) {
+  return NULL;
+}
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Times ITERATIONS rounds of spawning a child with a real spthread, having it
+// exit and reaping it with waitpid, while `idle` other processes exist
+static void bench_spawn_wait(int idle) {
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* parent = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                              "bench", false, NULL);
+  currentJob = parent->pid;
+  for (int i = 0; i < idle; i++) {
+    k_proc_create(parent, no_thread, STDIN_FILENO, STDOUT_FILENO, "idle", true,
+                  NULL);
+  }
+
+  uint64_t start = now_ns();
+  for (int i = 0; i < ITERATIONS; i++) {
+    pid_t child = s_spawn(noop, NULL, STDIN_FILENO, STDOUT_FILENO, "noop",
+                          false, NULL);
+    currentJob = child;
+    s_exit();
+    currentJob = parent->pid;
+    if (s_waitpid(child, NULL, true) != child) {
+      u_error("spawn_bench: waitpid did not reap the child");
+      exit(EXIT_FAILURE);
+    }
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  printf(
+      "{\"bench\":\"spawn_wait\",\"processes\":%d,\"iterations\":%d,"
+      "\"elapsed_ns\":%llu,\"ns_per_op\":%.1f,\"ops_per_sec\":%.1f}\n",
+      idle, ITERATIONS, (unsigned long long)elapsed,
+      (double)elapsed / ITERATIONS, ITERATIONS * 1e9 / elapsed);
+  fflush(stdout);
+
+  k_free_lists();
+  pidCount = 0;
+}
+
+// Times creating n processes without host threads and then freeing them
+// all, the kernel-side cost of spawning and tearing down a process
+static void bench_create(int n) {
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  uint64_t start = now_ns();
+  pcb* parent = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                              "bench", false, NULL);
+  for (int i = 1; i < n; i++) {
+    k_proc_create(parent, no_thread, STDIN_FILENO, STDOUT_FILENO, "child",
+                  true, NULL);
+  }
+  uint64_t created = now_ns();
+  k_free_lists();
+  uint64_t freed = now_ns();
+  pidCount = 0;
+
+  printf(
+      "{\"bench\":\"create\",\"processes\":%d,\"pcb_bytes\":%zu,"
+      "\"create_ns_per_proc\":%.1f,\"free_ns_per_proc\":%.1f}\n",
+      n, sizeof(pcb), (double)(created - start) / n,
+      (double)(freed - created) / n);
+  fflush(stdout);
+}
+
+// Times reaping n exited children with waitpid(-1)
+static void bench_reap_all(int n) {
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* parent = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                              "bench", false, NULL);
+  for (int i = 0; i < n; i++) {
+    pcb* child = k_proc_create(parent, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                               "child", true, NULL);
+    currentJob = child->pid;
+    s_exit();
+  }
+  currentJob = parent->pid;
+
+  uint64_t start = now_ns();
+  int reaped = 0;
+  while (s_waitpid(-1, NULL, true) > 0) {
+    reaped++;
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  printf(
+      "{\"bench\":\"reap_all\",\"processes\":%d,\"reaped\":%d,"
+      "\"elapsed_ns\":%llu,\"ns_per_op\":%.1f}\n",
+      n, reaped, (unsigned long long)elapsed, (double)elapsed / n);
+  fflush(stdout);
+
+  k_free_lists();
+  pidCount = 0;
+}
+
+// Times reaping a child which has n descendants, either as a chain (each
+// process the parent of the next) or fanned out directly under the child
+static void bench_teardown(int n, bool chain) {
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* parent = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                              "bench", false, NULL);
+  pcb* root = k_proc_create(parent, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                            "root", true, NULL);
+  pcb* last = root;
+  for (int i = 0; i < n; i++) {
+    pcb* desc = k_proc_create(chain ? last : root, no_thread, STDIN_FILENO,
+                              STDOUT_FILENO, "desc", false, NULL);
+    last = desc;
+  }
+  currentJob = root->pid;
+  s_exit();
+  currentJob = parent->pid;
+
+  uint64_t start = now_ns();
+  pid_t reaped = s_waitpid(root->pid, NULL, true);
+  uint64_t elapsed = now_ns() - start;
+
+  printf(
+      "{\"bench\":\"teardown\",\"shape\":\"%s\",\"processes\":%d,"
+      "\"reaped\":%s,\"remaining\":%d,\"elapsed_ns\":%llu}\n",
+      chain ? "chain" : "fan", n, reaped > 0 ? "true" : "false",
+      PCBDeque_Size(PCBList), (unsigned long long)elapsed);
+  fflush(stdout);
+
+  k_free_lists();
+  pidCount = 0;
+}
+
+// Times stopping, continuing and terminating a job of n processes by
+// signalling its process group
+static void bench_killpg(int n) {
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* shell = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                             "bench", false, NULL);
+  // skip pid 1: stopping or continuing a child of the shell prints a notice
+  pidCount++;
+  pcb* leader = k_proc_create(shell, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                              "leader", false, NULL);
+  s_setpgid(leader->pid, leader->pid);
+  for (int i = 1; i < n; i++) {
+    k_proc_create(leader, no_thread, STDIN_FILENO, STDOUT_FILENO, "member",
+                  false, NULL);
+  }
+  currentJob = shell->pid;
+
+  uint64_t start = now_ns();
+  s_killpg(leader->pid, P_SIGSTOP);
+  uint64_t stopped = now_ns();
+  s_killpg(leader->pid, P_SIGCONT);
+  uint64_t continued = now_ns();
+  s_killpg(leader->pid, P_SIGTERM);
+  uint64_t terminated = now_ns();
+
+  printf(
+      "{\"bench\":\"killpg\",\"processes\":%d,\"stop_ns\":%llu,"
+      "\"cont_ns\":%llu,\"term_ns\":%llu,\"ns_per_member\":%.1f}\n",
+      n, (unsigned long long)(stopped - start),
+      (unsigned long long)(continued - stopped),
+      (unsigned long long)(terminated - continued),
+      (double)(terminated - start) / (3.0 * n));
+  fflush(stdout);
+
+  k_free_lists();
+  pidCount = 0;
+}
+
+// Times CHURN_ITERATIONS rounds of creating a child without a thread, having
+// it exit and reaping it while n other processes exist, which wraps around
+// the PID space, and then looking up each live process by pid
+static void bench_churn(int n) {
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* parent = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                              "bench", false, NULL);
+  for (int i = 0; i < n; i++) {
+    k_proc_create(parent, no_thread, STDIN_FILENO, STDOUT_FILENO, "idle", true,
+                  NULL);
+  }
+
+  pid_t max_pid = 0;
+  uint64_t start = now_ns();
+  for (int i = 0; i < CHURN_ITERATIONS; i++) {
+    pcb* child = k_proc_create(parent, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                               "child", true, NULL);
+    if (child == NULL) {
+      P_ERRNO = EPIDS;
+      u_error("spawn_bench: ran out of pids");
+      exit(EXIT_FAILURE);
+    }
+    max_pid = child->pid > max_pid ? child->pid : max_pid;
+    currentJob = child->pid;
+    s_exit();
+    currentJob = parent->pid;
+    if (s_waitpid(child->pid, NULL, true) <= 0) {
+      u_error("spawn_bench: waitpid did not reap the child");
+      exit(EXIT_FAILURE);
+    }
+  }
+  uint64_t churned = now_ns();
+  int found = 0;
+  pid_t pid;
+  for (uint32_t it = PIDDeque_Begin(parent->child_pids);
+       PIDDeque_Next(parent->child_pids, &it, &pid);) {
+    found += PCBDequeJobSearch(PCBList, pid) != NULL;
+  }
+  uint64_t looked_up = now_ns();
+
+  printf(
+      "{\"bench\":\"pid_churn\",\"processes\":%d,\"iterations\":%d,"
+      "\"pid_max\":%d,\"max_pid\":%d,\"ns_per_op\":%.1f,"
+      "\"lookup_ns\":%.1f}\n",
+      n, CHURN_ITERATIONS, k_pid_max(), max_pid,
+      (double)(churned - start) / CHURN_ITERATIONS,
+      (double)(looked_up - churned) / (found > 0 ? found : 1));
+  fflush(stdout);
+
+  k_free_lists();
+  pidCount = 0;
+}
+
+/**
+ * @brief Measures spawn/exit/waitpid throughput as the number of live
+ * processes grows, the size of a PCB and the cost of creating and freeing
+ * processes without threads, and the cost of reaping many exited children with
+ * waitpid(-1) or a process with a deep or wide tree of descendants, and of
+ * signalling a whole process group, and of creating and reaping enough
+ * processes to wrap around the PID space, printing one JSON object per process
+ * count.
+ *
+ * Example Usage: ./bin/spawn_bench
+ */
+int main(int argc, char* argv[]) {
+  int num_counts = sizeof(process_counts) / sizeof(process_counts[0]);
+  for (int i = 0; i < num_counts; i++) {
+    bench_spawn_wait(process_counts[i]);
+  }
+  for (int i = 0; i < num_counts; i++) {
+    bench_create(process_counts[i]);
+  }
+  for (int i = 0; i < num_counts; i++) {
+    bench_reap_all(process_counts[i]);
+  }
+  for (int i = 0; i < num_counts; i++) {
+    bench_teardown(process_counts[i], true);
+    bench_teardown(process_counts[i], false);
+  }
+  for (int i = 0; i < num_counts; i++) {
+    bench_killpg(process_counts[i]);
+  }
+  for (int i = 0; i < num_counts; i++) {
+    bench_churn(process_counts[i]);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE 1
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fat/fat_helper.h"
+#include "kernel/kernel.h"
+#include "kernel/kernel_system.h"
+#include "util/PCBDeque.h"
+#include "util/PIDDeque.h"
+#include "util/globals.h"
+#include "util/os_errors.h"
+
+// Global Variables
+int fs_fd = -1;          // File Descriptor for FAT
+uint16_t* fat = NULL;    // FAT
+global_fdt g_fdt[1024];  // Global File Descriptor Table
+int g_counter = 0;
+pid_t fgJob = 0;
+bool logged_out = false;
+pid_t plus_pid = -1;
+pid_t currentJob = 0;
+int P_ERRNO = 0;
+PCBDeque* PCBList;
+PIDDeque* priorityList[MAX_PRIORITY_LEVELS + 1];
+pid_t pidCount = 0;
+int ticks;
+char* logFileName;
+int logfd;
+TerminalHistory* curr_history;
+
+// A file system of 8 FAT blocks of 512 bytes, as "mkfs NAME 8 1" makes it
+#define FAT_BLOCKS 8
+#define BLOCK_SIZE 512
+#define WRITES 4096
+#define WRITE_SIZE 16
+
+static const int file_counts[] = {10, 100, 1000};
+static const int write_batches[] = {1, 8, 64};
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Makes and mounts an empty file system in a temporary host file
+static void make_fs(char* path) {
+  int fd = mkstemp(path);
+  int fat_size = FAT_BLOCKS * BLOCK_SIZE;
+  uint16_t* table = calloc(fat_size / 2, sizeof(uint16_t));
+  table[0] = (FAT_BLOCKS << 8) | 1;
+  table[1] = 0xFFFF;
+  if (fd == -1 || write(fd, table, fat_size) != fat_size ||
+      ftruncate(fd, fat_size + BLOCK_SIZE * (fat_size / 2 - 1)) == -1) {
+    perror("submit_bench: making the file system");
+    exit(EXIT_FAILURE);
+  }
+  free(table);
+  close(fd);
+  int num_blocks;
+  int block_size;
+  if (mount(path, &num_blocks, &block_size) == -1) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void unmount(char* path) {
+  munmap(fat, FAT_BLOCKS * BLOCK_SIZE);
+  close(fs_fd);
+  unlink(path);
+}
+
+// Touches count new files, one s_touch each or all in one s_submit
+static void bench_touch(int count, bool batched) {
+  char path[] = "/tmp/submit_bench.XXXXXX";
+  make_fs(path);
+  char names[count][32];
+  p_subentry ops[count];
+  for (int i = 0; i < count; i++) {
+    snprintf(names[i], sizeof(names[i]), "file%d", i);
+    ops[i] = (p_subentry){.op = P_SUB_TOUCH, .fname = names[i]};
+  }
+
+  uint64_t start = now_ns();
+  int touched = 0;
+  if (batched) {
+    touched = s_submit(ops, count);
+  } else {
+    for (int i = 0; i < count; i++) {
+      touched += s_touch(names[i]) == 0;
+    }
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  if (touched != count) {
+    fprintf(stderr, "submit_bench: touched %d of %d files\n", touched, count);
+    exit(EXIT_FAILURE);
+  }
+  printf(
+      "{\"bench\":\"submit_touch\",\"files\":%d,\"batched\":%s,"
+      "\"us_per_file\":%.2f}\n",
+      count, batched ? "true" : "false", (double)elapsed / count / 1000);
+  fflush(stdout);
+  unmount(path);
+}
+
+// Writes WRITES small records to one file, batch writes per s_submit
+static void bench_write(int batch) {
+  char path[] = "/tmp/submit_bench.XXXXXX";
+  make_fs(path);
+  k_allocate_lists();
+  spthread_t no_thread = {0};
+  pcb* proc = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                            "writer", false, NULL);
+  currentJob = proc->pid;
+  s_touch("log");
+  int fd = s_open("log", F_WRITE);
+
+  static char records[WRITES][WRITE_SIZE];
+  p_subentry ops[batch];
+  uint64_t start = now_ns();
+  for (int i = 0; i < WRITES; i += batch) {
+    for (int j = 0; j < batch; j++) {
+      snprintf(records[i + j], WRITE_SIZE, "record %7d\n", i + j);
+      ops[j] = (p_subentry){.op = P_SUB_WRITE,
+                            .fd = fd,
+                            .buf = records[i + j],
+                            .n = WRITE_SIZE - 1};
+    }
+    if (s_submit(ops, batch) != batch) {
+      fprintf(stderr, "submit_bench: write failed\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  // The joined writes must leave the records in order
+  static char contents[WRITES * WRITE_SIZE];
+  s_lseek(fd, 0, F_SEEK_SET);
+  int total = WRITES * (WRITE_SIZE - 1);
+  if (s_read(fd, total, contents) != total) {
+    fprintf(stderr, "submit_bench: records were lost\n");
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0; i < WRITES; i++) {
+    if (memcmp(contents + i * (WRITE_SIZE - 1), records[i], WRITE_SIZE - 1)) {
+      fprintf(stderr, "submit_bench: records were reordered\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  printf(
+      "{\"bench\":\"submit_write\",\"batch\":%d,\"writes\":%d,"
+      "\"write_bytes\":%d,\"us_per_write\":%.2f}\n",
+      batch, WRITES, WRITE_SIZE - 1, (double)elapsed / WRITES / 1000);
+  fflush(stdout);
+
+  s_close(fd);
+  k_free_lists();
+  pidCount = 0;
+  unmount(path);
+}
+
+int main(int argc, char* argv[]) {
+  for (int i = 0; i < sizeof(file_counts) / sizeof(file_counts[0]); i++) {
+    bench_touch(file_counts[i], false);
+    bench_touch(file_counts[i], true);
+  }
+  for (int i = 0; i < sizeof(write_batches) / sizeof(write_batches[0]); i++) {
+    bench_write(write_batches[i]);
+  }
+  return EXIT_SUCCESS;
+}
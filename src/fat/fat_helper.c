@@ -1,4 +1,5 @@
 #include "./fat_helper.h"
+#include "../kernel/aio.h"
 #include "./fat_globals.h"
 
 int mount(char* fs_name, int* num_blocks, int* block_size) {
@@ -278,6 +279,278 @@ int k_touch(char* file_name) {
   return 0;
 }
 
+// Finds a file's entry in the in-memory copy of the root directory, stopping
+// at the end of each block's entries like k_file_exists
+static dir_entry* find_entry(char* dir, int dir_blocks, int block_size,
+                             char* file_name) {
+  int per_block = block_size / sizeof(dir_entry);
+  for (int b = 0; b < dir_blocks; b++) {
+    dir_entry* entries = (dir_entry*)(dir + b * block_size);
+    for (int i = 0; i < per_block && entries[i].name[0] != END_DIR; i++) {
+      if (entries[i].name[0] != DEL_FILE &&
+          strncmp(entries[i].name, file_name, 32) == 0) {
+        return &entries[i];
+      }
+    }
+  }
+  return NULL;
+}
+
+// Finds the first deleted or unused entry, as k_touch would
+static dir_entry* free_entry(char* dir, int dir_blocks, int block_size) {
+  int per_block = block_size / sizeof(dir_entry);
+  for (int b = 0; b < dir_blocks; b++) {
+    dir_entry* entries = (dir_entry*)(dir + b * block_size);
+    for (int i = 0; i < per_block; i++) {
+      if (entries[i].name[0] == DEL_FILE || entries[i].name[0] == END_DIR) {
+        return &entries[i];
+      }
+    }
+  }
+  return NULL;
+}
+
+int k_touch_many(char** file_names, int n, int* results) {
+  int num_blocks;
+  int block_size;
+  k_metadata(&num_blocks, &block_size);
+  off_t data_start = (off_t)num_blocks * block_size;
+
+  // Leave room for the blocks the new entries could add to the directory
+  int per_block = block_size / sizeof(dir_entry);
+  int capacity = (n + per_block - 1) / per_block;
+  for (uint16_t curr = 1; curr != 0xFFFF; curr = (fat)[curr]) {
+    capacity++;
+  }
+  uint16_t* blocks = malloc(capacity * sizeof(uint16_t));
+  bool* dirty = malloc(capacity * sizeof(bool));
+  char* dir = malloc(capacity * block_size);
+
+  // Read the whole root directory, one block per read
+  int dir_blocks = 0;
+  for (uint16_t curr = 1; curr != 0xFFFF; curr = (fat)[curr]) {
+    if (pread(fs_fd, dir + dir_blocks * block_size, block_size,
+              data_start + (curr - 1) * block_size) != block_size) {
+      P_ERRNO = EHOST;
+      u_error("touch: error reading root directory");
+      free(blocks);
+      free(dirty);
+      free(dir);
+      return -1;
+    }
+    blocks[dir_blocks] = curr;
+    dirty[dir_blocks] = false;
+    dir_blocks++;
+  }
+
+  int failed = 0;
+  bool fat_changed = false;
+  time_t now = time(NULL);
+  for (int i = 0; i < n; i++) {
+    dir_entry* entry = find_entry(dir, dir_blocks, block_size, file_names[i]);
+    if (entry == NULL) {
+      entry = free_entry(dir, dir_blocks, block_size);
+      if (entry == NULL) {
+        // Need to create new block for root directory entry
+        int rootEntry = k_open_entry();
+        if (rootEntry == -1) {
+          P_ERRNO = EFD;
+          u_error("touch: no open entries in FAT");
+          results[i] = -1;
+          failed++;
+          continue;
+        }
+        (fat)[rootEntry] = 0xFFFF;
+        (fat)[blocks[dir_blocks - 1]] = rootEntry;
+        fat_changed = true;
+
+        memset(dir + dir_blocks * block_size, 0, block_size);
+        blocks[dir_blocks] = rootEntry;
+        entry = (dir_entry*)(dir + dir_blocks * block_size);
+        dir_blocks++;
+      }
+      strncpy(entry->name, file_names[i], 32);
+      entry->size = 0;
+      entry->firstBlock = 0;
+      entry->type = TYPE_FILE;
+      entry->perm = PERM_READ_WRITE;
+    }
+    entry->time = now;
+    dirty[((char*)entry - dir) / block_size] = true;
+    results[i] = 0;
+  }
+
+  // Write each changed block back once
+  if (fat_changed) {
+    msync(fat, num_blocks * block_size, MS_SYNC);
+  }
+  for (int b = 0; b < dir_blocks; b++) {
+    if (dirty[b] &&
+        pwrite(fs_fd, dir + b * block_size, block_size,
+               data_start + (blocks[b] - 1) * block_size) != block_size) {
+      P_ERRNO = EHOST;
+      u_error("touch: error writing updated directory entry");
+      for (int i = 0; i < n; i++) {
+        results[i] = -1;
+      }
+      failed = n;
+      break;
+    }
+  }
+
+  free(blocks);
+  free(dirty);
+  free(dir);
+  return failed > 0 ? -1 : 0;
+}
+
+// Returns the block after block in its file, allocating one at the end of the
+// chain if grow is set, or -1 if there is none
+static int next_block(int block, bool grow, bool* fat_changed) {
+  if ((fat)[block] != 0xFFFF) {
+    return (fat)[block];
+  }
+  if (!grow) {
+    return -1;
+  }
+  int entry = k_open_entry();
+  if (entry == -1) {
+    return -1;
+  }
+  (fat)[entry] = 0xFFFF;
+  (fat)[block] = entry;
+  *fat_changed = true;
+  return entry;
+}
+
+int k_map_io(int fd,
+             int n,
+             bool for_write,
+             fat_extent** extents,
+             int* num_extents,
+             int* first_block) {
+  if (fd <= STDERR_FILENO || fd > 1023 || !g_fdt[fd].open || n < 0) {
+    P_ERRNO = EFD;
+    u_error("map_io: not an open file");
+    return -1;
+  }
+  global_fdt* fd_entry = &g_fdt[fd];
+  if (fd_entry->perm == F_NONE || (for_write && fd_entry->perm == F_READ)) {
+    P_ERRNO = EFD;
+    u_error("map_io: file is not open for this operation");
+    return -1;
+  }
+
+  int num_blocks;
+  int block_size;
+  k_metadata(&num_blocks, &block_size);
+
+  dir_entry directory;
+  loc_entry location;
+  int file_exists = k_file_exists(fd_entry->name, &directory, &location);
+  if (file_exists == 0) {
+    P_ERRNO = ENOENT;
+    u_error("map_io: file does not exist");
+    return -1;
+  } else if (file_exists == 2) {
+    return -1;
+  }
+
+  int count = n;
+  if (!for_write) {
+    count = fd_entry->offset >= fd_entry->size
+                ? 0
+                : fd_entry->size - fd_entry->offset;
+    count = count < n ? count : n;
+  }
+  *extents = NULL;
+  *num_extents = 0;
+  *first_block = 0;
+  if (count == 0) {
+    return 0;
+  }
+
+  // Give an empty file its first block
+  bool fat_changed = false;
+  bool dir_changed = false;
+  if (directory.firstBlock == 0) {
+    if (!for_write) {
+      return 0;
+    }
+    int entry = k_open_entry();
+    if (entry == -1) {
+      P_ERRNO = EHOST;
+      u_error("map_io: no free blocks in the FAT");
+      return -1;
+    }
+    (fat)[entry] = 0xFFFF;
+    directory.firstBlock = entry;
+    fat_changed = true;
+    dir_changed = true;
+  }
+
+  // Find the block holding the offset
+  int block = directory.firstBlock;
+  for (int i = 0; block != -1 && i < fd_entry->offset / block_size; i++) {
+    block = next_block(block, for_write, &fat_changed);
+  }
+
+  // The bytes span at most one block more than they fill
+  fat_extent* out =
+      malloc(((count + block_size - 1) / block_size + 1) * sizeof(fat_extent));
+  int used = 0;
+  off_t data_start = (off_t)num_blocks * block_size;
+  int in_block = fd_entry->offset % block_size;
+  int mapped = 0;
+  while (block != -1 && mapped < count) {
+    int len = block_size - in_block < count - mapped ? block_size - in_block
+                                                     : count - mapped;
+    off_t pos = data_start + (off_t)(block - 1) * block_size + in_block;
+    if (used > 0 && out[used - 1].pos + out[used - 1].len == pos) {
+      out[used - 1].len += len;
+    } else {
+      out[used++] = (fat_extent){pos, len};
+    }
+    mapped += len;
+    in_block = 0;
+    if (mapped < count) {
+      block = next_block(block, for_write, &fat_changed);
+    }
+  }
+
+  if (fat_changed) {
+    msync(fat, num_blocks * block_size, MS_SYNC);
+  }
+  if (for_write && fd_entry->offset + mapped > directory.size) {
+    directory.size = fd_entry->offset + mapped;
+    fd_entry->size = directory.size;
+    dir_changed = true;
+  }
+  if (dir_changed &&
+      pwrite(fs_fd, &directory, sizeof(dir_entry),
+             data_start + (location.block - 1) * block_size +
+                 location.offset) != sizeof(dir_entry)) {
+    P_ERRNO = EHOST;
+    u_error("map_io: error writing updated directory entry");
+    free(out);
+    return -1;
+  }
+  if (mapped == 0) {
+    // a write found no free block; a read's offset is past the block chain
+    P_ERRNO = for_write ? EHOST : EFD;
+    u_error(for_write ? "map_io: no free blocks in the FAT"
+                      : "map_io: offset is past the end of the file's blocks");
+    free(out);
+    return -1;
+  }
+
+  *extents = out;
+  *num_extents = used;
+  *first_block = directory.firstBlock;
+  fd_entry->offset += mapped;
+  return mapped;
+}
+
 int k_mv(char* source_file, char* dest_file) {
   int num_blocks;
   int block_size;
@@ -966,11 +1239,12 @@ int k_unlink(const char* fName) {
     return -1;
   }
 
-  // Update FAT
+  // Update FAT, once asynchronous I/O into the blocks is done
   int curr_block = directory.firstBlock;
   if (curr_block == 0) {
     return 0;
   }
+  k_aio_settle(curr_block);
   while ((fat)[curr_block] != 0xFFFF) {
     int next_block = (fat)[curr_block];
     (fat)[curr_block] = 0x0000;
@@ -1289,8 +1563,11 @@ int k_write(int fd, const char* str, int n) {
         curr_block = (fat)[curr_block];
       }
 
-      // Update the FAT
+      // Update the FAT, once asynchronous I/O into the blocks cut off is done
       int prev_block = fat[curr_block];
+      if (prev_block != 0xFFFF) {
+        k_aio_settle(directory.firstBlock);
+      }
       fat[curr_block] = 0xFFFF;
       msync(fat, num_blocks * block_size, MS_SYNC);
 
@@ -1406,8 +1683,11 @@ int k_write(int fd, const char* str, int n) {
       curr_block = (fat)[curr_block];
     }
 
-    // Update the FAT
+    // Update the FAT, once asynchronous I/O into the blocks cut off is done
     int prev_block = fat[curr_block];
+    if (prev_block != 0xFFFF) {
+      k_aio_settle(directory.firstBlock);
+    }
     fat[curr_block] = 0xFFFF;
     msync(fat, num_blocks * block_size, MS_SYNC);
 
@@ -60,6 +60,11 @@ typedef struct loc_entry {
   int offset;
 } loc_entry;
 
+typedef struct fat_extent {
+  off_t pos;  // Offset in the host file
+  int len;
+} fat_extent;
+
 /**
  * @brief Mounts the file system
  *
@@ -87,6 +92,41 @@ int k_findperm(char* file_name);
  */
 int k_touch(char* file_name);
 
+/**
+ * @brief Touches several files in one pass over the root directory: reads
+ * each directory block once, creates or updates every entry in memory and
+ * writes each changed block back once
+ *
+ * @param file_names Files to create/update, in order
+ * @param n Number of files
+ * @param results Set to 0 for each file touched, -1 for each that failed
+ * @return int 0 if every file was touched, -1 if any failed
+ */
+int k_touch_many(char** file_names, int n, int* results);
+
+/**
+ * @brief Finds where the next n bytes at a file's offset lie in the host
+ * file, so they can be read or written there later, and moves the offset past
+ * them. For a write, allocates the blocks they need and grows the file.
+ * Adjacent blocks are merged into one extent
+ *
+ * @param fd File descriptor of a PennFAT file (not stdin/stdout/stderr)
+ * @param n Number of bytes
+ * @param for_write Whether the bytes will be written
+ * @param extents Set to a malloc'd array of extents, for the caller to free
+ * @param num_extents Set to the number of extents
+ * @param first_block Set to the file's first block, which names the file for
+ * as long as it has blocks
+ * @return int Number of bytes mapped (fewer than n if a read reaches the end
+ * of the file or the FAT fills up), -1 if error
+ */
+int k_map_io(int fd,
+             int n,
+             bool for_write,
+             fat_extent** extents,
+             int* num_extents,
+             int* first_block);
+
 /**
  * @brief Renames the source file to the destination file
  *
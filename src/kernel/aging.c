@@ -0,0 +1,55 @@
+#include "aging.h"
+#include "../util/PCBDeque.h"
+#include "../util/PIDDeque.h"
+#include "kernel.h"
+#include "runqueue.h"
+
+static int aging_threshold = 0;  // 0 while aging is off
+static int aging_max_boost = AGING_DEFAULT_MAX_BOOST;
+
+// The job at the front of each queue and the tick it got there
+static pid_t front_pid[MAX_PRIORITY_LEVELS];
+static int front_since[MAX_PRIORITY_LEVELS];
+
+int k_aging_set(int threshold, int max_boost) {
+  if (threshold < 0 || max_boost < 1 || max_boost >= MAX_PRIORITY_LEVELS) {
+    return -1;
+  }
+  aging_threshold = threshold;
+  aging_max_boost = max_boost;
+  for (int level = 0; level < MAX_PRIORITY_LEVELS; level++) {
+    front_pid[level] = -1;
+  }
+  return 0;
+}
+
+void k_age_runnable() {
+  if (aging_threshold == 0) {
+    return;
+  }
+  // lowest level number first, so a job raised this tick is not raised again
+  for (int level = 1; level < k_num_levels(); level++) {
+    pid_t pid;
+    if (!k_runqueue_peek_front(level, &pid)) {
+      front_pid[level] = -1;
+      continue;
+    }
+    pcb* proc = PCBDequeJobSearch(PCBList, pid);
+    if (proc == NULL) {
+      continue;
+    }
+    // a new front job, or the same one back after running, starts over
+    if (pid != front_pid[level] || proc->queued_tick > front_since[level]) {
+      front_pid[level] = pid;
+      front_since[level] = ticks;
+    }
+    if (proc->boost >= aging_max_boost ||
+        ticks - front_since[level] < aging_threshold) {
+      continue;
+    }
+    k_runqueue_pop_front(level, &pid);
+    proc->boost++;
+    // the front, so the boost is not spent queueing behind a busy level
+    k_runqueue_push_front(level - 1, pid);
+  }
+}
@@ -0,0 +1,34 @@
+#ifndef AGING_H
+#define AGING_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Optional anti-starvation aging. The job at the front of a run queue is the
+// next one its level will dispatch, so it builds up credit for every tick the
+// lottery picks another level. Once its credit reaches the aging threshold it
+// is moved to the front of the next higher queue, up to the maximum boost.
+// Waiting behind other jobs of the same level earns no credit, so a busy
+// level does not boost all of its jobs at once. The boost lasts until the job
+// is next dispatched or leaves its queue, and ps shows it as the raised level
+// followed by '*'.
+///////////////////////////////////////////////////////////////////////////////
+
+#define AGING_DEFAULT_MAX_BOOST 2
+
+/**
+ * @brief Configures aging.
+ *
+ * @param threshold ticks the front job of a queue may wait before it is
+ * boosted, 0 turns aging off
+ * @param max_boost how many levels a job can be raised by, at least 1 and below
+ *        MAX_PRIORITY_LEVELS
+ * @return 0 on success, -1 if an argument is out of range
+ */
+int k_aging_set(int threshold, int max_boost);
+
+/**
+ * @brief Boosts the front job of each queue once it has waited long enough.
+ * O(1) per tick. Called by the scheduler every tick before it picks a job.
+ */
+void k_age_runnable(void);
+
+#endif
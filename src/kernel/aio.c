@@ -0,0 +1,310 @@
+#include "aio.h"
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../fat/fat_helper.h"
+#include "fdpoll.h"
+#include "kernel.h"
+
+#define AIO_SPIN_NS 1000000  // how long s_await waits before blocking
+
+// The life of a ticket. A process claims a free one by setting its pid,
+// fills it in and queues it; the I/O thread takes the oldest queued one, runs
+// it and marks it done; the process collects the result and frees it. A
+// process dropping a queued operation claims it back from the queue, so the
+// thread can never start it. Since the pid is set in the same step as the
+// claim, a process killed while it is still filling a ticket in can always
+// be found as its owner.
+enum aio_state { AIO_FREE, AIO_CLAIMED, AIO_QUEUED, AIO_RUNNING, AIO_DONE };
+
+typedef struct aio_op {
+  _Atomic int state;
+  _Atomic pid_t pid;  // owner, or -1 while the ticket is free
+  uint64_t seq;       // submission order; the oldest queued runs first
+  bool write;
+  char* buf;
+  fat_extent* extents;  // where the bytes lie in the host file
+  int num_extents;
+  int first_block;  // of the file, to find its operations by
+  int result;    // bytes copied, or -1 if the host I/O failed
+  bool waiting;  // the owner is blocked in k_aio_await
+} aio_op;
+
+static aio_op ops[AIO_MAX];
+static uint64_t next_seq = 0;
+
+static pthread_t worker;
+static sem_t queued;  // posted once per operation queued
+static _Atomic bool worker_running = false;
+static _Atomic bool worker_stop = false;
+
+void k_aio_init() {
+  for (int id = 0; id < AIO_MAX; id++) {
+    ops[id].extents = NULL;
+    atomic_store_explicit(&ops[id].state, AIO_FREE, memory_order_relaxed);
+    atomic_store_explicit(&ops[id].pid, -1, memory_order_relaxed);
+  }
+  next_seq = 0;
+}
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void release(aio_op* op) {
+  free(op->extents);
+  op->extents = NULL;
+  atomic_store_explicit(&op->state, AIO_FREE, memory_order_release);
+  atomic_store_explicit(&op->pid, -1, memory_order_release);
+}
+
+static aio_op* oldest_queued() {
+  aio_op* oldest = NULL;
+  for (int id = 0; id < AIO_MAX; id++) {
+    if (atomic_load_explicit(&ops[id].state, memory_order_acquire) ==
+            AIO_QUEUED &&
+        (oldest == NULL || ops[id].seq < oldest->seq)) {
+      oldest = &ops[id];
+    }
+  }
+  return oldest;
+}
+
+// Copies an operation's bytes between its buffer and the host file
+static int copy(aio_op* op) {
+  int done = 0;
+  for (int i = 0; i < op->num_extents; i++) {
+    fat_extent* ext = &op->extents[i];
+    ssize_t res = op->write ? pwrite(fs_fd, op->buf + done, ext->len, ext->pos)
+                            : pread(fs_fd, op->buf + done, ext->len, ext->pos);
+    if (res != ext->len) {
+      return -1;
+    }
+    done += ext->len;
+  }
+  return done;
+}
+
+static void* worker_main(void* arg) {
+  while (true) {
+    sem_wait(&queued);
+    if (atomic_load_explicit(&worker_stop, memory_order_acquire)) {
+      return NULL;
+    }
+    // the operation posted for may have been dropped since
+    aio_op* op = oldest_queued();
+    int expected = AIO_QUEUED;
+    if (op == NULL || !atomic_compare_exchange_strong_explicit(
+                          &op->state, &expected, AIO_RUNNING,
+                          memory_order_acq_rel, memory_order_acquire)) {
+      continue;
+    }
+    op->result = copy(op);
+    atomic_store_explicit(&op->state, AIO_DONE, memory_order_release);
+  }
+}
+
+static int start_worker() {
+  if (atomic_load_explicit(&worker_running, memory_order_acquire)) {
+    return 0;
+  }
+  sem_init(&queued, 0, 0);
+  atomic_store_explicit(&worker_stop, false, memory_order_release);
+
+  // Like the trace flusher, the I/O thread must never take SIGALRM or the
+  // signals meant for PennOS processes
+  sigset_t all, old;
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+  int res = pthread_create(&worker, NULL, worker_main, NULL);
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+  if (res != 0) {
+    sem_destroy(&queued);
+    return -1;
+  }
+  atomic_store_explicit(&worker_running, true, memory_order_release);
+  return 0;
+}
+
+void k_aio_free() {
+  if (atomic_load_explicit(&worker_running, memory_order_acquire)) {
+    atomic_store_explicit(&worker_stop, true, memory_order_release);
+    sem_post(&queued);
+    pthread_join(worker, NULL);
+    sem_destroy(&queued);
+    atomic_store_explicit(&worker_running, false, memory_order_release);
+  }
+  for (int id = 0; id < AIO_MAX; id++) {
+    release(&ops[id]);
+  }
+}
+
+int k_aio_submit(int fd, char* buf, int n, bool write) {
+  pid_t pid = k_get_proc()->pid;
+  aio_op* op = NULL;
+  for (int id = 0; id < AIO_MAX && op == NULL; id++) {
+    pid_t expected = -1;
+    if (atomic_compare_exchange_strong_explicit(&ops[id].pid, &expected, pid,
+                                                memory_order_acquire,
+                                                memory_order_relaxed)) {
+      op = &ops[id];
+    }
+  }
+  if (op == NULL) {
+    P_ERRNO = EAIO;
+    return -1;
+  }
+  atomic_store_explicit(&op->state, AIO_CLAIMED, memory_order_release);
+
+  // Before mapping, so a submit that fails here leaves the file as it was
+  if (start_worker() == -1) {
+    P_ERRNO = EHOST;
+    release(op);
+    return -1;
+  }
+  int num_extents;
+  int count =
+      k_map_io(fd, n, write, &op->extents, &num_extents, &op->first_block);
+  if (count == -1) {
+    release(op);
+    return -1;
+  }
+  op->seq = next_seq++;
+  op->write = write;
+  op->buf = buf;
+  op->num_extents = num_extents;
+  op->result = count;
+  op->waiting = false;
+
+  // Nothing to copy at the end of a file
+  if (count == 0) {
+    atomic_store_explicit(&op->state, AIO_DONE, memory_order_release);
+    return op - ops;
+  }
+  atomic_store_explicit(&op->state, AIO_QUEUED, memory_order_release);
+  sem_post(&queued);
+  return op - ops;
+}
+
+// The calling process's operation with this ticket, or NULL
+static aio_op* owned(int ticket) {
+  if (ticket < 0 || ticket >= AIO_MAX) {
+    return NULL;
+  }
+  int state = atomic_load_explicit(&ops[ticket].state, memory_order_acquire);
+  if (state == AIO_FREE || state == AIO_CLAIMED ||
+      ops[ticket].pid != k_get_proc()->pid) {
+    return NULL;
+  }
+  return &ops[ticket];
+}
+
+int k_aio_await(int ticket) {
+  aio_op* op = owned(ticket);
+  if (op == NULL) {
+    return -1;
+  }
+  // A blocked process only runs again on a later tick, far longer than a copy
+  // usually takes, so first give the I/O thread the host CPU for a moment
+  uint64_t give_up = now_ns() + AIO_SPIN_NS;
+  while (atomic_load_explicit(&op->state, memory_order_acquire) != AIO_DONE &&
+         now_ns() < give_up) {
+    sched_yield();
+  }
+  pcb* proc = k_get_proc();
+  while (atomic_load_explicit(&op->state, memory_order_acquire) != AIO_DONE) {
+    op->waiting = true;
+    k_block(proc);
+    spthread_suspend(proc->curr_thread);
+  }
+  op->waiting = false;
+  int result = op->result;
+  release(op);
+  return result;
+}
+
+short k_aio_poll(int ticket) {
+  aio_op* op = owned(ticket);
+  if (op == NULL) {
+    return P_POLLNVAL;
+  }
+  return atomic_load_explicit(&op->state, memory_order_acquire) == AIO_DONE
+             ? P_POLLIN
+             : 0;
+}
+
+void k_aio_tick() {
+  for (int id = 0; id < AIO_MAX; id++) {
+    if (atomic_load_explicit(&ops[id].state, memory_order_acquire) !=
+        AIO_DONE) {
+      continue;
+    }
+    // Woken every tick until they collect it, in case the owner was stopped
+    // between checking the operation and blocking
+    if (ops[id].waiting) {
+      pcb* proc = PCBDequeJobSearch(PCBList, ops[id].pid);
+      if (proc != NULL) {
+        k_unblock(proc);
+      }
+    }
+    k_poll_notify_aio(id);
+  }
+}
+
+void k_aio_settle(int first_block) {
+  for (int id = 0; id < AIO_MAX; id++) {
+    aio_op* op = &ops[id];
+    int state = atomic_load_explicit(&op->state, memory_order_acquire);
+    if ((state != AIO_QUEUED && state != AIO_RUNNING) ||
+        op->first_block != first_block) {
+      continue;
+    }
+    // Run a queued one here rather than wait for the I/O thread to get to
+    // it; the thread skips it once it is no longer queued
+    int expected = AIO_QUEUED;
+    if (atomic_compare_exchange_strong_explicit(
+            &op->state, &expected, AIO_RUNNING, memory_order_acq_rel,
+            memory_order_acquire)) {
+      op->result = copy(op);
+      atomic_store_explicit(&op->state, AIO_DONE, memory_order_release);
+      continue;
+    }
+    while (atomic_load_explicit(&op->state, memory_order_acquire) ==
+           AIO_RUNNING) {
+      sched_yield();
+    }
+  }
+}
+
+void k_aio_forget(pcb* proc) {
+  for (int id = 0; id < AIO_MAX; id++) {
+    aio_op* op = &ops[id];
+    if (atomic_load_explicit(&op->pid, memory_order_acquire) != proc->pid) {
+      continue;
+    }
+    // claimed but not yet queued: the owner will never get to queue it
+    int state = atomic_load_explicit(&op->state, memory_order_acquire);
+    if (state == AIO_FREE || state == AIO_CLAIMED) {
+      release(op);
+      continue;
+    }
+    int expected = AIO_QUEUED;
+    if (!atomic_compare_exchange_strong_explicit(
+            &op->state, &expected, AIO_CLAIMED, memory_order_acq_rel,
+            memory_order_acquire)) {
+      // already started: its buffer is in use until it is done
+      while (atomic_load_explicit(&op->state, memory_order_acquire) ==
+             AIO_RUNNING) {
+        sched_yield();
+      }
+    }
+    release(op);
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef AIO_H
+#define AIO_H
+
+#include <stdbool.h>
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Asynchronous reads and writes of PennFAT files. s_aread and s_awrite work
+// out where the bytes lie in the host file, move the descriptor's offset past
+// them and hand the copy to a kernel I/O thread, returning a ticket at once.
+// The process stays runnable meanwhile and collects the result with s_await,
+// or waits for several tickets and descriptors together with s_poll. Its
+// buffer must stay untouched until then.
+//
+// The I/O thread is a host thread, not a PennOS process, so the copy really
+// runs alongside the process that asked for it. It only ever preads and
+// pwrites the data blocks it was given, at positions fixed when the
+// operation was queued: the FAT, the directory and the descriptor table are
+// updated by the calling process as for s_read and s_write, so the rest of
+// the file system needs no lock. Only freeing blocks has to wait: unlinking
+// or cutting a file short first settles the file's operations, so none of
+// them copies into a block that already belongs to another file. The thread and the kernel share only each
+// operation's state, which moves from queued to running to done; the
+// scheduler sees finished operations on its next tick and wakes the
+// processes waiting for them.
+///////////////////////////////////////////////////////////////////////////////
+
+#define AIO_MAX 64  // operations in flight at once, across all processes
+
+/**
+ * @brief Marks every ticket free. Called from k_allocate_lists; the I/O
+ * thread starts with the first operation.
+ */
+void k_aio_init(void);
+
+/**
+ * @brief Stops the I/O thread, dropping queued operations, and frees every
+ * ticket.
+ */
+void k_aio_free(void);
+
+/**
+ * @brief Queues a read of up to n bytes into buf, or a write of n bytes from
+ * buf, at a file's offset for the calling process, and moves the offset past
+ * them.
+ *
+ * @return a ticket for the operation, or -1 if fd is not an open PennFAT file
+ * or AIO_MAX operations are in flight
+ */
+int k_aio_submit(int fd, char* buf, int n, bool write);
+
+/**
+ * @brief Waits until one of the calling process's operations is done, then
+ * frees the ticket. Yields the host CPU to the I/O thread for up to a
+ * millisecond before blocking the process.
+ *
+ * @return the number of bytes read or written, -1 if the ticket is not the
+ * caller's or the host I/O failed
+ */
+int k_aio_await(int ticket);
+
+/**
+ * @brief Returns P_POLLIN if one of the calling process's operations is done
+ * and 0 if it is not (see fdpoll.h), or P_POLLNVAL if the ticket is not
+ * the caller's.
+ */
+short k_aio_poll(int ticket);
+
+/**
+ * @brief Wakes the processes awaiting or polling operations that have
+ * finished. Called by the scheduler every tick.
+ */
+void k_aio_tick(void);
+
+/**
+ * @brief Finishes the queued and running operations on the file whose first
+ * block is first_block, running queued ones on the calling thread. Called
+ * before the file's blocks are freed.
+ */
+void k_aio_settle(int first_block);
+
+/**
+ * @brief Drops the operations of a process that is exiting, terminated or
+ * cleaned up, waiting for one the I/O thread has already started, since it
+ * copies into or out of the process's memory.
+ */
+void k_aio_forget(pcb* proc);
+
+#endif
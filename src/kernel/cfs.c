@@ -0,0 +1,63 @@
+#include "cfs.h"
+#include <stdlib.h>
+#include "../util/PCBDeque.h"
+#include "../util/PIDHeap.h"
+#include "../util/macros.h"
+#include "runqueue.h"
+
+static PIDHeap* timeline = NULL;  // runnable jobs keyed by vruntime
+static uint64_t min_vruntime = 0;  // least vruntime dispatched so far
+static int depth[MAX_PRIORITY_LEVELS];  // runnable jobs per level
+
+void k_cfs_init() {
+  timeline = PIDHeap_Allocate();
+  min_vruntime = 0;
+  for (int i = 0; i < MAX_PRIORITY_LEVELS; i++) {
+    depth[i] = 0;
+  }
+}
+
+void k_cfs_free() {
+  PIDHeap_Free(timeline);
+  timeline = NULL;
+}
+
+void k_cfs_enqueue(pcb* proc) {
+  if (proc->vruntime < min_vruntime) {
+    proc->vruntime = min_vruntime;
+  }
+  if (PIDHeap_Push(timeline, proc->pid, proc->vruntime)) {
+    depth[proc->priority]++;
+  }
+}
+
+void k_cfs_remove(pcb* proc) {
+  if (PIDHeap_Remove(timeline, proc->pid)) {
+    depth[proc->priority]--;
+  }
+}
+
+bool k_cfs_contains(pcb* proc) {
+  return PIDHeap_Contains(timeline, proc->pid);
+}
+
+pid_t k_cfs_next() {
+  pid_t pid = -1;
+  if (!PIDHeap_Pop_Min(timeline, &pid)) {
+    return -1;
+  }
+  pcb* proc = PCBDequeJobSearch(PCBList, pid);
+  if (proc == NULL) {
+    return pid;
+  }
+  depth[proc->priority]--;
+  if (proc->vruntime > min_vruntime) {
+    min_vruntime = proc->vruntime;
+  }
+  proc->vruntime += CFS_WEIGHT_SCALE / k_level_weight(proc->priority);
+  return pid;
+}
+
+int k_cfs_depth(int level) {
+  return depth[level];
+}
@@ -0,0 +1,60 @@
+#ifndef CFS_H
+#define CFS_H
+
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Virtual-runtime ("completely fair") scheduling, used instead of the lottery
+// when pennos is booted with -S cfs. Every tick a job runs adds
+// CFS_WEIGHT_SCALE / weight to its vruntime, where weight is the lottery
+// weight of its priority level, and the runnable job with the least vruntime
+// runs next. Jobs of equal priority therefore alternate exactly, and over any
+// window each level gets its weighted share to within a tick per job.
+//
+// Runnable jobs are kept in a pairing heap keyed by vruntime. A job that
+// becomes runnable again after sleeping, or is new, starts no further back
+// than the least vruntime seen so far, so it cannot bank credit while idle.
+///////////////////////////////////////////////////////////////////////////////
+
+#define CFS_WEIGHT_SCALE (1ULL << 20)
+
+/**
+ * @brief Allocates the heap of runnable jobs. Called from k_allocate_lists.
+ */
+void k_cfs_init(void);
+
+/**
+ * @brief Frees the heap of runnable jobs.
+ */
+void k_cfs_free(void);
+
+/**
+ * @brief Makes a job runnable in O(1).
+ */
+void k_cfs_enqueue(pcb* proc);
+
+/**
+ * @brief Removes a job from the runnable jobs in O(log n) amortized. Does
+ * nothing if it is not runnable.
+ */
+void k_cfs_remove(pcb* proc);
+
+/**
+ * @brief Returns whether a job is among the runnable jobs.
+ */
+bool k_cfs_contains(pcb* proc);
+
+/**
+ * @brief Removes the runnable job with the least vruntime and charges it the
+ * tick it is about to run, in O(log n) amortized.
+ *
+ * @return its pid, or -1 if no job is runnable
+ */
+pid_t k_cfs_next(void);
+
+/**
+ * @brief Returns the number of runnable jobs at a priority level.
+ */
+int k_cfs_depth(int level);
+
+#endif
@@ -0,0 +1,350 @@
+#include "cgroup.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "../util/PCBDeque.h"
+#include "../util/PIDDeque.h"
+#include "../util/macros.h"
+#include "kernel.h"
+#include "runqueue.h"
+
+typedef struct cpu_group {
+  bool in_use;
+  char name[CGROUP_NAME_MAX];
+  int parent;      // id of the parent group, -1 for the root
+  int shares;      // weight against sibling groups
+  int quota;       // ticks per period, 0 for no limit
+  int period;      // ticks per accounting period
+  int period_end;  // tick the current period ends
+  int used;        // ticks charged in this period, descendants included
+  long total;      // ticks charged since the group was created
+  int throttles;   // # periods in which the quota ran out
+  bool throttled;  // out of quota until the period ends
+  int members;     // # processes in the group itself
+  int queued;      // runnable jobs in the group's queues and its descendants'
+                   // (for the root, only its descendants')
+  uint64_t vruntime;      // charged ticks scaled by 1 / shares
+  uint64_t own_vruntime;  // the same for the group's own jobs as one entity
+  uint64_t min_vruntime;  // vruntime of the child or own jobs picked last
+  PIDDeque* queue[MAX_PRIORITY_LEVELS];  // the group's own runnable jobs
+  uint32_t nonempty;                     // bit i set while queue[i] has a job
+} cpu_group;
+
+static cpu_group groups[CGROUP_MAX];
+static int depth[MAX_PRIORITY_LEVELS];  // grouped runnable jobs per level
+
+static void group_init(int id, const char* name, int parent) {
+  cpu_group* grp = &groups[id];
+  *grp = (cpu_group){
+      .in_use = true,
+      .parent = parent,
+      .shares = CGROUP_DEFAULT_SHARES,
+      .period = CGROUP_DEFAULT_PERIOD,
+      .period_end = ticks + CGROUP_DEFAULT_PERIOD,
+  };
+  snprintf(grp->name, sizeof(grp->name), "%s", name);
+  for (int i = 0; i < k_num_levels(); i++) {
+    grp->queue[i] = PIDDeque_Allocate();
+  }
+}
+
+static void group_free(int id) {
+  cpu_group* grp = &groups[id];
+  for (int i = 0; i < k_num_levels(); i++) {
+    PIDDeque_Free(grp->queue[i]);
+    grp->queue[i] = NULL;
+  }
+  grp->in_use = false;
+}
+
+void k_cgroup_init() {
+  memset(groups, 0, sizeof(groups));
+  memset(depth, 0, sizeof(depth));
+  group_init(CGROUP_ROOT, "root", -1);
+}
+
+void k_cgroup_free() {
+  for (int id = 0; id < CGROUP_MAX; id++) {
+    if (groups[id].in_use) {
+      group_free(id);
+    }
+  }
+}
+
+static bool valid(int id) {
+  return id >= 0 && id < CGROUP_MAX && groups[id].in_use;
+}
+
+int k_cgroup_lookup(const char* name) {
+  for (int id = 0; id < CGROUP_MAX; id++) {
+    if (groups[id].in_use && strcmp(groups[id].name, name) == 0) {
+      return id;
+    }
+  }
+  return -1;
+}
+
+int k_cgroup_create(const char* name, int parent) {
+  size_t len = strlen(name);
+  if (len == 0 || len >= CGROUP_NAME_MAX || !valid(parent) ||
+      k_cgroup_lookup(name) != -1) {
+    return -1;
+  }
+  for (int id = 1; id < CGROUP_MAX; id++) {
+    if (!groups[id].in_use) {
+      group_init(id, name, parent);
+      return id;
+    }
+  }
+  return -1;
+}
+
+int k_cgroup_destroy(int id) {
+  if (id == CGROUP_ROOT || !valid(id) || groups[id].members > 0) {
+    return -1;
+  }
+  for (int child = 1; child < CGROUP_MAX; child++) {
+    if (groups[child].in_use && groups[child].parent == id) {
+      return -1;
+    }
+  }
+  group_free(id);
+  return 0;
+}
+
+int k_cgroup_set(int id, int shares, int quota, int period) {
+  if (id == CGROUP_ROOT || !valid(id) || shares <= 0 ||
+      shares > CGROUP_MAX_SHARES || period <= 0 || quota < 0 ||
+      quota > period) {
+    return -1;
+  }
+  cpu_group* grp = &groups[id];
+  grp->shares = shares;
+  grp->quota = quota;
+  grp->period = period;
+  grp->period_end = ticks + period;
+  grp->used = 0;
+  grp->throttled = false;
+  return 0;
+}
+
+void k_cgroup_join(pcb* proc, int id) {
+  proc->cgroup = valid(id) ? id : CGROUP_ROOT;
+  groups[proc->cgroup].members++;
+}
+
+void k_cgroup_leave(pcb* proc) {
+  if (proc->cgroup != CGROUP_ROOT) {
+    k_cgroup_remove(proc);
+  }
+  groups[proc->cgroup].members--;
+  proc->cgroup = CGROUP_ROOT;
+}
+
+int k_cgroup_attach(pid_t pid, int id) {
+  pcb* proc = PCBDequeJobSearch(PCBList, pid);
+  if (proc == NULL || !valid(id) || P_WIFEXITED(proc->status) ||
+      P_WIFSIGNALED(proc->status)) {
+    return -1;
+  }
+  if (proc->cgroup == id) {
+    return 0;
+  }
+  // the running job is in no queue and is put back after its tick
+  bool queued = P_WIFRUNNING(proc->status) && pid != currentJob;
+  if (queued) {
+    k_dequeue_runnable(proc);
+  }
+  groups[proc->cgroup].members--;
+  k_cgroup_join(proc, id);
+  if (queued) {
+    k_runqueue_enqueue(proc);
+  }
+  return 0;
+}
+
+// Adds delta to the runnable count of a group and all of its ancestors
+static void add_queued(int id, int delta) {
+  for (; id != -1; id = groups[id].parent) {
+    groups[id].queued += delta;
+  }
+}
+
+void k_cgroup_enqueue(pcb* proc) {
+  cpu_group* grp = &groups[proc->cgroup];
+  int level = k_run_level(proc);
+  if (PIDDequeJobSearch(grp->queue[level], proc->pid)) {
+    return;
+  }
+  PIDDeque_Push_Back(grp->queue[level], proc->pid);
+  grp->nonempty |= 1u << level;
+  depth[level]++;
+  add_queued(proc->cgroup, 1);
+}
+
+bool k_cgroup_contains(pcb* proc) {
+  return PIDDequeJobSearch(groups[proc->cgroup].queue[k_run_level(proc)],
+                           proc->pid);
+}
+
+static void update_bit(cpu_group* grp, int level) {
+  if (PIDDeque_Size(grp->queue[level]) == 0) {
+    grp->nonempty &= ~(1u << level);
+  }
+}
+
+void k_cgroup_remove(pcb* proc) {
+  cpu_group* grp = &groups[proc->cgroup];
+  int level = k_run_level(proc);
+  if (!PIDSearchAndDelete(grp->queue[level], proc->pid)) {
+    return;
+  }
+  update_bit(grp, level);
+  depth[level]--;
+  add_queued(proc->cgroup, -1);
+}
+
+int k_cgroup_depth(int level) {
+  return depth[level];
+}
+
+void k_cgroup_tick() {
+  for (int id = 0; id < CGROUP_MAX; id++) {
+    cpu_group* grp = &groups[id];
+    if (grp->in_use && ticks >= grp->period_end) {
+      grp->period_end = ticks + grp->period;
+      grp->used = 0;
+      grp->throttled = false;
+    }
+  }
+}
+
+// Number of runnable best-effort jobs in the root group itself
+static int root_jobs() {
+  int jobs = 0;
+  for (int i = 0; i < k_num_levels(); i++) {
+    jobs += k_runqueue_depth(i) - depth[i];
+  }
+  return jobs;
+}
+
+// Whether a group or one of its descendants has a job that may run now
+static bool eligible(int id) {
+  cpu_group* grp = &groups[id];
+  if (grp->throttled || grp->queued == 0) {
+    return false;
+  }
+  if (grp->nonempty != 0) {
+    return true;
+  }
+  for (int child = 1; child < CGROUP_MAX; child++) {
+    if (groups[child].in_use && groups[child].parent == id &&
+        eligible(child)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Charges a tick to a group and its ancestors, throttling any that run out
+// of quota
+static void charge(int id) {
+  for (; id != -1; id = groups[id].parent) {
+    cpu_group* grp = &groups[id];
+    grp->used++;
+    grp->total++;
+    if (grp->quota > 0 && grp->used >= grp->quota && !grp->throttled) {
+      grp->throttled = true;
+      grp->throttles++;
+    }
+  }
+}
+
+static pid_t pop_own(cpu_group* grp) {
+  int level = k_runqueue_draw(grp->nonempty);
+  pid_t pid = -1;
+  PIDDeque_Pop_Front(grp->queue[level], &pid);
+  update_bit(grp, level);
+  depth[level]--;
+  return pid;
+}
+
+pid_t k_cgroup_next() {
+  if (groups[CGROUP_ROOT].queued == 0) {
+    pid_t pid = k_runqueue_next_best_effort();
+    if (pid != -1) {
+      charge(CGROUP_ROOT);
+    }
+    return pid;
+  }
+  int id = CGROUP_ROOT;
+  while (true) {
+    cpu_group* grp = &groups[id];
+    bool own = id == CGROUP_ROOT ? root_jobs() > 0 : grp->nonempty != 0;
+    // an entity that was not competing catches up to the last one picked
+    int best = -1;  // -1 for the group's own jobs
+    uint64_t best_vruntime = UINT64_MAX;
+    if (own) {
+      if (grp->own_vruntime < grp->min_vruntime) {
+        grp->own_vruntime = grp->min_vruntime;
+      }
+      best_vruntime = grp->own_vruntime;
+    }
+    for (int child = 1; child < CGROUP_MAX; child++) {
+      cpu_group* c = &groups[child];
+      if (!c->in_use || c->parent != id || !eligible(child)) {
+        continue;
+      }
+      if (c->vruntime < grp->min_vruntime) {
+        c->vruntime = grp->min_vruntime;
+      }
+      if (c->vruntime < best_vruntime) {
+        best = child;
+        best_vruntime = c->vruntime;
+      }
+    }
+    if (best == -1 && !own) {
+      return -1;
+    }
+    grp->min_vruntime = best_vruntime;
+
+    if (best == -1) {
+      grp->own_vruntime += CGROUP_SHARE_SCALE / CGROUP_DEFAULT_SHARES;
+      pid_t pid;
+      if (id == CGROUP_ROOT) {
+        pid = k_runqueue_next_best_effort();
+      } else {
+        pid = pop_own(grp);
+        add_queued(id, -1);
+      }
+      charge(id);
+      return pid;
+    }
+    groups[best].vruntime += CGROUP_SHARE_SCALE / groups[best].shares;
+    id = best;
+  }
+}
+
+void k_cgroup_print(int fd) {
+  char* header =
+      "ID\tPARENT\tSHARES\tQUOTA\tUSED\tTOTAL\tTHROT\tPROCS\tNAME\n";
+  k_write(fd, header, strlen(header));
+  for (int id = 0; id < CGROUP_MAX; id++) {
+    cpu_group* grp = &groups[id];
+    if (!grp->in_use) {
+      continue;
+    }
+    char quota[24];
+    if (grp->quota > 0) {
+      snprintf(quota, sizeof(quota), "%d/%d", grp->quota, grp->period);
+    } else {
+      snprintf(quota, sizeof(quota), "-");
+    }
+    char row[160];
+    snprintf(row, sizeof(row), "%d\t%d\t%d\t%s\t%d%s\t%ld\t%d\t%d\t%s\n", id,
+             grp->parent, grp->shares, quota, grp->used,
+             grp->throttled ? "*" : "", grp->total, grp->throttles,
+             grp->members, grp->name);
+    k_write(fd, row, strlen(row));
+  }
+}
@@ -0,0 +1,143 @@
+#ifndef CGROUP_H
+#define CGROUP_H
+
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// CPU groups. Every process belongs to a group, by default its parent's, and
+// groups form a tree under the root group, which holds the shell. Each tick
+// the scheduler first walks down the tree, at every group choosing between
+// its child groups and its own jobs, and only then picks a job. So a group
+// gets the CPU its shares entitle it to however many jobs it runs, and a
+// tenant cannot starve the others by spawning more of them.
+//
+// Among siblings the one that has run least relative to its shares goes
+// next: every tick charges CGROUP_SHARE_SCALE / shares to the groups on the
+// path, the way cfs charges jobs. A group's own jobs count as one more child
+// with CGROUP_DEFAULT_SHARES. Groups that were idle start no further back than
+// the sibling that ran last, so they cannot bank credit. Within a group jobs
+// are picked by the same lottery over levels as the root's, whose own jobs
+// stay in the run queues of runqueue.h under either policy.
+//
+// A group may also have a hard quota of ticks per period, counting the ticks
+// of its descendants. Once it is used up the group and everything below it
+// is throttled until the period ends, even if the CPU would otherwise idle.
+// Real-time jobs (see edf.h) are scheduled ahead of all groups and are not
+// charged to them.
+///////////////////////////////////////////////////////////////////////////////
+
+#define CGROUP_ROOT 0
+#define CGROUP_MAX 64  // groups that can exist at once, including the root
+#define CGROUP_NAME_MAX 16
+#define CGROUP_DEFAULT_SHARES 1024
+#define CGROUP_MAX_SHARES 262144
+#define CGROUP_DEFAULT_PERIOD 10  // ticks per accounting period
+#define CGROUP_SHARE_SCALE (1ULL << 20)
+
+/**
+ * @brief Creates the root group. Called from k_allocate_lists.
+ */
+void k_cgroup_init(void);
+
+/**
+ * @brief Frees every group's queues.
+ */
+void k_cgroup_free(void);
+
+/**
+ * @brief Creates a group with the default shares and no quota.
+ *
+ * @param name a unique name of at most CGROUP_NAME_MAX - 1 characters
+ * @param parent the id of the parent group
+ * @return the new group's id, or -1 if the name is invalid or taken, the
+ * parent does not exist or CGROUP_MAX groups exist
+ */
+int k_cgroup_create(const char* name, int parent);
+
+/**
+ * @brief Destroys a group that has no processes and no child groups.
+ *
+ * @return 0 on success, -1 if the group is the root, does not exist or is
+ * not empty
+ */
+int k_cgroup_destroy(int id);
+
+/**
+ * @brief Looks a group up by name.
+ *
+ * @return its id, or -1 if there is no such group
+ */
+int k_cgroup_lookup(const char* name);
+
+/**
+ * @brief Sets the shares of a group and its quota of ticks per period, 0 for
+ * none. Starts a new period and lifts any throttling.
+ *
+ * @return 0 on success, -1 if the group does not exist, is the root or an
+ * argument is out of range
+ */
+int k_cgroup_set(int id, int shares, int quota, int period);
+
+/**
+ * @brief Moves a process into a group, requeueing it if it is runnable.
+ * Children it creates later start in the same group.
+ *
+ * @return 0 on success, -1 if the process or the group does not exist
+ */
+int k_cgroup_attach(pid_t pid, int id);
+
+/**
+ * @brief Adds a new process to a group. Called from k_proc_create.
+ */
+void k_cgroup_join(pcb* proc, int id);
+
+/**
+ * @brief Removes a process that is being cleaned up from its group.
+ */
+void k_cgroup_leave(pcb* proc);
+
+/**
+ * @brief Makes a job of a group other than the root runnable.
+ */
+void k_cgroup_enqueue(pcb* proc);
+
+/**
+ * @brief Removes a job of a group other than the root from its group's
+ * queue.
+ */
+void k_cgroup_remove(pcb* proc);
+
+/**
+ * @brief Returns whether a job of a group other than the root is in its
+ * group's queue.
+ */
+bool k_cgroup_contains(pcb* proc);
+
+/**
+ * @brief Returns the number of runnable jobs at a level over all groups other
+ * than the root.
+ */
+int k_cgroup_depth(int level);
+
+/**
+ * @brief Starts the accounting periods that are due, lifting throttling.
+ * Called by the scheduler every tick before it picks a job.
+ */
+void k_cgroup_tick(void);
+
+/**
+ * @brief Picks a group and removes the next job within it, charging the tick
+ * to the group and its ancestors. Skips the walk entirely while no group
+ * other than the root has a runnable job.
+ *
+ * @return the job's pid, or -1 if nothing runnable may run
+ */
+pid_t k_cgroup_next(void);
+
+/**
+ * @brief Writes one line per group: its shares, quota, ticks used in this
+ * period and in total, how often it was throttled, and its processes.
+ */
+void k_cgroup_print(int fd);
+
+#endif
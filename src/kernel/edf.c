@@ -0,0 +1,114 @@
+#include "edf.h"
+#include "../util/PCBDeque.h"
+#include "../util/PIDHeap.h"
+#include "kernel.h"
+#include "trace.h"
+
+static PIDHeap* ready = NULL;      // jobs with budget left, by deadline
+static PIDHeap* throttled = NULL;  // jobs out of budget, by next release
+static int reserved = 0;           // utilisation of every real-time job
+
+void k_edf_init() {
+  ready = PIDHeap_Allocate();
+  throttled = PIDHeap_Allocate();
+  reserved = 0;
+}
+
+void k_edf_free() {
+  PIDHeap_Free(ready);
+  PIDHeap_Free(throttled);
+  ready = throttled = NULL;
+}
+
+// Rounded up, so that rounding never admits more than the CPU can give
+static int utilisation(int period, int budget) {
+  if (period == 0) {
+    return 0;
+  }
+  return (budget * EDF_UTIL_SCALE + period - 1) / period;
+}
+
+int k_edf_setattr(pcb* proc, int period, int budget) {
+  bool leave = period == 0 && budget == 0;
+  if (!leave && (period <= 0 || budget <= 0 || budget > period)) {
+    return -1;
+  }
+  int others = reserved - utilisation(proc->rt_period, proc->rt_budget);
+  if (others + utilisation(period, budget) > EDF_MAX_UTIL) {
+    return -1;
+  }
+  reserved = others + utilisation(period, budget);
+  proc->rt_period = period;
+  proc->rt_budget = budget;
+  proc->rt_left = budget;
+  proc->rt_deadline = ticks + period;
+  return 0;
+}
+
+void k_edf_forget(pcb* proc) {
+  reserved -= utilisation(proc->rt_period, proc->rt_budget);
+  proc->rt_period = proc->rt_budget = 0;
+}
+
+void k_edf_enqueue(pcb* proc) {
+  if (ticks >= proc->rt_deadline) {
+    proc->rt_deadline = ticks + proc->rt_period;
+    proc->rt_left = proc->rt_budget;
+  }
+  PIDHeap_Push(proc->rt_left > 0 ? ready : throttled, proc->pid,
+               proc->rt_deadline);
+}
+
+void k_edf_remove(pcb* proc) {
+  if (!PIDHeap_Remove(ready, proc->pid)) {
+    PIDHeap_Remove(throttled, proc->pid);
+  }
+}
+
+bool k_edf_contains(pcb* proc) {
+  return PIDHeap_Contains(ready, proc->pid) ||
+         PIDHeap_Contains(throttled, proc->pid);
+}
+
+// Moves a job to the first of its periods that ends after this tick, with a
+// full budget
+static void next_period(pcb* proc) {
+  while (proc->rt_deadline <= ticks) {
+    proc->rt_deadline += proc->rt_period;
+  }
+  proc->rt_left = proc->rt_budget;
+  PIDHeap_Push(ready, proc->pid, proc->rt_deadline);
+}
+
+void k_edf_tick() {
+  pid_t pid;
+  uint64_t deadline;
+  while (PIDHeap_Peek_Min(throttled, &pid, &deadline) && deadline <= ticks) {
+    PIDHeap_Pop_Min(throttled, &pid);
+    pcb* proc = PCBDequeJobSearch(PCBList, pid);
+    if (proc != NULL) {
+      next_period(proc);
+    }
+  }
+  while (PIDHeap_Peek_Min(ready, &pid, &deadline) && deadline <= ticks) {
+    PIDHeap_Pop_Min(ready, &pid);
+    pcb* proc = PCBDequeJobSearch(PCBList, pid);
+    if (proc != NULL) {
+      proc->rt_misses++;
+      k_trace_event_ext(TRACE_MISSED, proc, proc->priority, proc->rt_deadline);
+      next_period(proc);
+    }
+  }
+}
+
+pid_t k_edf_next() {
+  pid_t pid = -1;
+  if (!PIDHeap_Pop_Min(ready, &pid)) {
+    return -1;
+  }
+  pcb* proc = PCBDequeJobSearch(PCBList, pid);
+  if (proc != NULL) {
+    proc->rt_left--;
+  }
+  return pid;
+}
@@ -0,0 +1,83 @@
+#ifndef EDF_H
+#define EDF_H
+
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Earliest-deadline-first real-time class. A job registered with
+// s_sched_setattr(pid, period, budget) may run for budget ticks in every
+// period of period ticks, and its deadline is the end of the current period.
+// Real-time jobs with budget left are dispatched ahead of every best-effort
+// level, earliest deadline first. A job that has used its budget is
+// throttled until its next period starts, so best-effort jobs get the ticks
+// real-time jobs have not reserved.
+//
+// Admission control keeps the total reserved utilisation (the sum of
+// budget / period) at or below EDF_MAX_UTIL, under which EDF meets every
+// deadline. A period that ends with budget left while the job was runnable
+// is a deadline miss, logged as MISSED with the missed deadline.
+///////////////////////////////////////////////////////////////////////////////
+
+// Utilisation is counted in thousandths of the CPU
+#define EDF_UTIL_SCALE 1000
+// Real-time jobs may reserve at most 90% of the ticks
+#define EDF_MAX_UTIL 900
+
+/**
+ * @brief Allocates the real-time queues. Called from k_allocate_lists.
+ */
+void k_edf_init(void);
+
+/**
+ * @brief Frees the real-time queues.
+ */
+void k_edf_free(void);
+
+/**
+ * @brief Sets the period and budget of a job that is in no run queue, or
+ * with both 0 returns it to best-effort scheduling. Its first period starts
+ * now.
+ *
+ * @return 0 on success, -1 if the arguments are invalid or admitting the job
+ * would reserve more than EDF_MAX_UTIL
+ */
+int k_edf_setattr(pcb* proc, int period, int budget);
+
+/**
+ * @brief Frees the utilisation reserved by a job being cleaned up.
+ */
+void k_edf_forget(pcb* proc);
+
+/**
+ * @brief Makes a real-time job runnable: ready if it has budget left in its
+ * period, throttled otherwise. A job that becomes runnable after its
+ * deadline starts a new period.
+ */
+void k_edf_enqueue(pcb* proc);
+
+/**
+ * @brief Removes a real-time job from the ready or throttled jobs.
+ */
+void k_edf_remove(pcb* proc);
+
+/**
+ * @brief Returns whether a real-time job is ready or throttled.
+ */
+bool k_edf_contains(pcb* proc);
+
+/**
+ * @brief Starts the new periods that are due: throttled jobs get their budget
+ * back, and ready jobs still holding budget past their deadline are logged
+ * as misses. Called by the scheduler every tick before it picks a job.
+ */
+void k_edf_tick(void);
+
+/**
+ * @brief Removes the ready real-time job with the earliest deadline and
+ * charges it the tick it is about to run.
+ *
+ * @return its pid, or -1 if no real-time job is ready
+ */
+pid_t k_edf_next(void);
+
+#endif
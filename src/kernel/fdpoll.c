@@ -0,0 +1,172 @@
+#include "fdpoll.h"
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "aio.h"
+#include "kernel.h"
+#include "mq.h"
+
+typedef struct poller {
+  pid_t pid;
+  p_pollfd* fds;  // the set passed to k_poll, on the poller's stack
+  int nfds;
+  int deadline;  // tick to give up at, -1 for no limit
+} poller;
+
+static poller* pollers = NULL;  // blocked in k_poll, in no particular order
+static int num_pollers = 0;
+static int capacity = 0;
+
+void k_poll_init() {
+  num_pollers = 0;
+}
+
+void k_poll_free() {
+  free(pollers);
+  pollers = NULL;
+  num_pollers = 0;
+  capacity = 0;
+}
+
+static void add(pid_t pid, p_pollfd* fds, int nfds, int deadline) {
+  if (num_pollers == capacity) {
+    capacity = capacity == 0 ? 4 : capacity * 2;
+    pollers = realloc(pollers, capacity * sizeof(poller));
+  }
+  pollers[num_pollers++] = (poller){pid, fds, nfds, deadline};
+}
+
+static void remove_pid(pid_t pid) {
+  for (int i = 0; i < num_pollers; i++) {
+    if (pollers[i].pid == pid) {
+      pollers[i] = pollers[--num_pollers];
+      return;
+    }
+  }
+}
+
+static bool stdin_ready() {
+  struct pollfd host = {.fd = STDIN_FILENO, .events = POLLIN};
+  return poll(&host, 1, 0) > 0;
+}
+
+// The events a descriptor of the calling process is ready for
+static short fd_ready(pcb* proc, int fd) {
+  if (fd < 0 || fd >= proc->fdt_size || proc->process_fdt[fd] == -1) {
+    return P_POLLNVAL;
+  }
+  int global = proc->process_fdt[fd];
+  if (global == STDIN_FILENO) {
+    return stdin_ready() ? P_POLLIN : 0;
+  }
+  if (global == STDOUT_FILENO || global == STDERR_FILENO) {
+    return P_POLLOUT;
+  }
+  if (!g_fdt[global].open) {
+    return P_POLLNVAL;
+  }
+  // files are read and written in place, so they never block
+  short ready = P_POLLIN;
+  if (g_fdt[global].perm == F_WRITE || g_fdt[global].perm == F_APPEND) {
+    ready |= P_POLLOUT;
+  }
+  return ready;
+}
+
+// Sets the revents of every entry, returning the number of entries with any
+static int scan(pcb* proc, p_pollfd* fds, int nfds) {
+  int ready = 0;
+  for (int i = 0; i < nfds; i++) {
+    short wanted = fds[i].events & (P_POLLIN | P_POLLOUT);
+    short state;
+    if (fds[i].events & P_POLLMQ) {
+      state = k_mq_poll(fds[i].fd);
+    } else if (fds[i].events & P_POLLAIO) {
+      state = k_aio_poll(fds[i].fd);
+    } else {
+      state = fd_ready(proc, fds[i].fd);
+    }
+    fds[i].revents = state & (wanted | P_POLLNVAL);
+    ready += fds[i].revents != 0;
+  }
+  return ready;
+}
+
+int k_poll(p_pollfd* fds, int nfds, int timeout) {
+  pcb* proc = k_get_proc();
+  int deadline = timeout > 0 ? ticks + timeout : -1;
+  while (true) {
+    int ready = scan(proc, fds, nfds);
+    if (ready > 0 || timeout == 0 || (deadline != -1 && ticks >= deadline)) {
+      return ready;
+    }
+    add(proc->pid, fds, nfds, deadline);
+    k_block(proc);
+    spthread_suspend(proc->curr_thread);
+    remove_pid(proc->pid);
+  }
+}
+
+static void wake(poller* p) {
+  pcb* proc = PCBDequeJobSearch(PCBList, p->pid);
+  if (proc != NULL) {
+    k_unblock(proc);
+  }
+}
+
+// Whether a poller waits for input on the host's stdin
+static bool wants_stdin(poller* p) {
+  pcb* proc = PCBDequeJobSearch(PCBList, p->pid);
+  for (int i = 0; proc != NULL && i < p->nfds; i++) {
+    int fd = p->fds[i].fd;
+    if (!(p->fds[i].events & (P_POLLMQ | P_POLLAIO)) &&
+        p->fds[i].events & P_POLLIN && fd >= 0 && fd < proc->fdt_size &&
+        proc->process_fdt[fd] == STDIN_FILENO) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void k_poll_tick() {
+  int input = -1;  // whether stdin has input, -1 until someone asks
+  for (int i = 0; i < num_pollers; i++) {
+    poller* p = &pollers[i];
+    if (p->deadline != -1 && ticks >= p->deadline) {
+      wake(p);
+    } else if (wants_stdin(p)) {
+      if (input == -1) {
+        input = stdin_ready();
+      }
+      if (input) {
+        wake(p);
+      }
+    }
+  }
+}
+
+// Wakes the pollers with an entry of the given kind (P_POLLMQ or P_POLLAIO)
+// for id
+static void notify(short kind, int id) {
+  for (int i = 0; i < num_pollers; i++) {
+    poller* p = &pollers[i];
+    for (int j = 0; j < p->nfds; j++) {
+      if (p->fds[j].events & kind && p->fds[j].fd == id) {
+        wake(p);
+        break;
+      }
+    }
+  }
+}
+
+void k_poll_notify_mq(int id) {
+  notify(P_POLLMQ, id);
+}
+
+void k_poll_notify_aio(int ticket) {
+  notify(P_POLLAIO, ticket);
+}
+
+void k_poll_forget(pcb* proc) {
+  remove_pid(proc->pid);
+}
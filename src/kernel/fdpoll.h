@@ -0,0 +1,78 @@
+#ifndef FDPOLL_H
+#define FDPOLL_H
+
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Waiting on several inputs at once. A process hands s_poll a set of its
+// file descriptors, message queues and asynchronous I/O tickets and blocks
+// in the inactive queue until one of them is ready or its timeout runs out,
+// instead of trying each with s_read in a loop.
+//
+// Readiness is pushed to the pollers rather than polled for them: a message
+// queue wakes the processes polling it whenever a message or a free slot
+// turns up, and the scheduler wakes pollers whose timeout ran out, and, once
+// per tick, those waiting on the host's stdin if it has input or on an I/O
+// operation that has finished. PennFAT files never block, so a set with an
+// open file in it is ready at once. A woken poller checks its whole set
+// again before it returns.
+///////////////////////////////////////////////////////////////////////////////
+
+#define P_POLLIN 0x1    // a read or receive would not block
+#define P_POLLOUT 0x2   // a write or send would not block
+#define P_POLLNVAL 0x4  // in revents only: no such descriptor or queue
+#define P_POLLMQ 0x8    // in events: fd is a message queue id, not a file
+                        // descriptor
+#define P_POLLAIO 0x10  // in events: fd is a ticket from s_aread/s_awrite,
+                        // ready for P_POLLIN once the operation is done
+
+typedef struct p_pollfd {
+  int fd;         // file descriptor of the calling process, queue or ticket
+  short events;   // P_POLLIN and/or P_POLLOUT, plus P_POLLMQ or P_POLLAIO
+  short revents;  // set to the events that are ready, or P_POLLNVAL
+} p_pollfd;
+
+/**
+ * @brief Empties the list of pollers. Called from k_allocate_lists.
+ */
+void k_poll_init(void);
+
+/**
+ * @brief Frees the list of pollers.
+ */
+void k_poll_free(void);
+
+/**
+ * @brief Sets each entry's revents and, if none is ready, blocks the calling
+ * process until one is or timeout ticks have passed.
+ *
+ * @param timeout ticks to wait at most, 0 to return at once, -1 for no limit
+ * @return the number of entries with revents set, 0 on timeout
+ */
+int k_poll(p_pollfd* fds, int nfds, int timeout);
+
+/**
+ * @brief Wakes the pollers whose timeout ran out or which wait on stdin while
+ * the host's stdin has input. Called by the scheduler every tick.
+ */
+void k_poll_tick(void);
+
+/**
+ * @brief Wakes the pollers that wait on a message queue. Called whenever a
+ * message or a free slot turns up in it, or it is destroyed.
+ */
+void k_poll_notify_mq(int id);
+
+/**
+ * @brief Wakes the pollers that wait on an I/O ticket. Called every tick
+ * while its operation is done and not yet collected.
+ */
+void k_poll_notify_aio(int ticket);
+
+/**
+ * @brief Takes a process that is exiting, terminated or cleaned up off the
+ * list of pollers.
+ */
+void k_poll_forget(pcb* proc);
+
+#endif
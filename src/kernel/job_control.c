@@ -0,0 +1,325 @@
+#include "job_control.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../fat/fat_helper.h"
+#include "../util/PCBDeque.h"
+#include "../util/PIDDeque.h"
+#include "../util/PIDIndex.h"
+#include "../util/macros.h"
+#include "kernel.h"
+#include "pidmap.h"
+
+#define JOB_TABLE_INITIAL 64
+
+static PIDDeque* stopped_jobs = NULL;     // back is the most recently stopped
+static PIDDeque* background_jobs = NULL;  // back is the most recent
+
+static pid_t* job_table = NULL;    // job_table[id] is the pgid of that job
+static uint64_t* used_ids = NULL;  // bit id is set while the id is taken
+static int job_capacity = 0;       // slots in job_table, a multiple of 64
+static int job_end = 1;            // one past the highest id in use
+
+static PIDIndex* groups = NULL;  // pgid -> PIDDeque of the group's members
+
+void k_jobs_init() {
+  stopped_jobs = PIDDeque_Allocate();
+  background_jobs = PIDDeque_Allocate();
+  job_table = calloc(JOB_TABLE_INITIAL, sizeof(pid_t));
+  used_ids = calloc(JOB_TABLE_INITIAL / 64, sizeof(uint64_t));
+  job_capacity = JOB_TABLE_INITIAL;
+  job_end = 1;
+  used_ids[0] = 1;  // job id 0 means "not a job"
+  groups = PIDIndex_Allocate();
+}
+
+void k_jobs_free() {
+  PIDDeque_Free(stopped_jobs);
+  PIDDeque_Free(background_jobs);
+  stopped_jobs = background_jobs = NULL;
+  free(job_table);
+  free(used_ids);
+  job_table = NULL;
+  used_ids = NULL;
+  job_capacity = 0;
+  for (int i = 0; i < groups->capacity; i++) {
+    if (groups->values[i] != NULL) {
+      PIDDeque_Free(groups->values[i]);
+    }
+  }
+  PIDIndex_Free(groups);
+  groups = NULL;
+}
+
+// Doubles the job table, returning the first new id or -1 on error
+static int grow_table() {
+  int capacity = job_capacity * 2;
+  pid_t* table = realloc(job_table, capacity * sizeof(pid_t));
+  if (table == NULL) {
+    return -1;
+  }
+  job_table = table;
+  uint64_t* used = realloc(used_ids, capacity / 64 * sizeof(uint64_t));
+  if (used == NULL) {
+    return -1;
+  }
+  used_ids = used;
+  memset(used_ids + job_capacity / 64, 0,
+         (capacity - job_capacity) / 64 * sizeof(uint64_t));
+  int first = job_capacity;
+  job_capacity = capacity;
+  return first;
+}
+
+// The first member of a group still in PCBList, or NULL
+static pcb* first_member(pid_t pgid) {
+  PIDDeque* members = PIDIndex_Get(groups, pgid);
+  if (members == NULL) {
+    return NULL;
+  }
+  pid_t pid;
+  for (uint32_t it = PIDDeque_Begin(members);
+       PIDDeque_Next(members, &it, &pid);) {
+    pcb* member = PCBDequeJobSearch(PCBList, pid);
+    if (member != NULL) {
+      return member;
+    }
+  }
+  return NULL;
+}
+
+int k_jobs_assign(pcb* proc) {
+  if (proc->job_id != 0) {
+    return proc->job_id;
+  }
+  int id = -1;
+  // the first word with a clear bit holds the lowest free id
+  for (int w = 0; w < job_capacity / 64; w++) {
+    if (~used_ids[w] != 0) {
+      id = w * 64 + __builtin_ctzll(~used_ids[w]);
+      break;
+    }
+  }
+  if (id == -1 && (id = grow_table()) == -1) {
+    return -1;
+  }
+  used_ids[id / 64] |= 1ULL << (id % 64);
+  job_table[id] = proc->pgid;
+  if (id >= job_end) {
+    job_end = id + 1;
+  }
+  // the whole group is the job; members joining later inherit the id
+  PIDDeque* members = PIDIndex_Get(groups, proc->pgid);
+  pid_t pid;
+  for (uint32_t it = PIDDeque_Begin(members);
+       PIDDeque_Next(members, &it, &pid);) {
+    pcb* member = PCBDequeJobSearch(PCBList, pid);
+    if (member != NULL) {
+      member->job_id = id;
+    }
+  }
+  proc->job_id = id;
+  return id;
+}
+
+static bool id_in_use(int job_id) {
+  return job_id > 0 && job_id < job_capacity &&
+         (used_ids[job_id / 64] & (1ULL << (job_id % 64)));
+}
+
+pcb* k_jobs_lookup(int job_id) {
+  if (!id_in_use(job_id)) {
+    return NULL;
+  }
+  // the leader stands for the job while it lives, then the oldest member
+  pid_t pgid = job_table[job_id];
+  pcb* leader = PCBDequeJobSearch(PCBList, pgid);
+  if (leader != NULL && leader->pgid == pgid) {
+    return leader;
+  }
+  return first_member(pgid);
+}
+
+// Frees the job id of a group that has no members left
+static void release_id(int job_id) {
+  if (!id_in_use(job_id)) {
+    return;
+  }
+  used_ids[job_id / 64] &= ~(1ULL << (job_id % 64));
+  while (job_end > 1 && !id_in_use(job_end - 1)) {
+    job_end--;
+  }
+}
+
+void k_jobs_print(int output_fd) {
+  for (int id = 1; id < job_end; id++) {
+    pcb* job = k_jobs_lookup(id);
+    if (job == NULL) {
+      continue;
+    }
+    char* status = job->status == STATUS_RUNNING    ? "running"
+                   : job->status == STATUS_STOPPED  ? "stopped"
+                   : job->status == STATUS_BLOCKED  ? "blocked"
+                   : job->status == STATUS_FINISHED ? "finished"
+                                                    : "terminated";
+    char message[100];
+    char plus = (job->pid == plus_pid) ? '+' : ' ';
+    snprintf(message, sizeof(message), "[%d]%c %s (%s)\n", id, plus,
+             job->process_name, status);
+    k_write(output_fd, message, strlen(message) + 1);
+  }
+}
+
+static pcb* back_of(PIDDeque* deque) {
+  pid_t pid = -1;
+  if (!PIDDeque_Peek_Back(deque, &pid)) {
+    return NULL;
+  }
+  return PCBDequeJobSearch(PCBList, pid);
+}
+
+pcb* k_jobs_last_stopped() {
+  return back_of(stopped_jobs);
+}
+
+pcb* k_jobs_current() {
+  pcb* job = back_of(stopped_jobs);
+  if (job == NULL) {
+    job = back_of(background_jobs);
+  }
+  return job;
+}
+
+// Every transition below recomputes plus_pid, so it never needs a scan
+static void update_plus() {
+  pcb* job = k_jobs_current();
+  // a job that is done keeps its + until it has been reported and reaped
+  if (job == NULL || job->status == STATUS_FINISHED ||
+      job->status == STATUS_TERMINATED) {
+    return;
+  }
+  plus_pid = job->pid;
+}
+
+void k_jobs_background(pcb* proc) {
+  PIDSearchAndDelete(background_jobs, proc->pid);
+  PIDDeque_Push_Back(background_jobs, proc->pid);
+  update_plus();
+}
+
+void k_jobs_stopped(pcb* proc) {
+  PIDSearchAndDelete(stopped_jobs, proc->pid);
+  PIDDeque_Push_Back(stopped_jobs, proc->pid);
+  k_jobs_background(proc);
+}
+
+void k_jobs_continued(pcb* proc) {
+  PIDSearchAndDelete(stopped_jobs, proc->pid);
+  update_plus();
+}
+
+void k_jobs_foreground(pcb* proc) {
+  PIDSearchAndDelete(stopped_jobs, proc->pid);
+  PIDSearchAndDelete(background_jobs, proc->pid);
+  update_plus();
+}
+
+static void leave_group(pcb* proc) {
+  PIDDeque* members = PIDIndex_Get(groups, proc->pgid);
+  if (members == NULL) {
+    return;
+  }
+  PIDSearchAndDelete(members, proc->pid);
+  if (PIDDeque_Size(members) == 0) {
+    // the job lasts as long as any process of its group
+    if (proc->job_id != 0 && job_table[proc->job_id] == proc->pgid) {
+      release_id(proc->job_id);
+    }
+    PIDIndex_Remove(groups, proc->pgid);
+    PIDDeque_Free(members);
+    // the leader frees its own pid in k_proc_cleanup
+    if (proc->pgid != proc->pid &&
+        PCBDequeJobSearch(PCBList, proc->pgid) == NULL) {
+      k_pid_release(proc->pgid);
+    }
+  }
+}
+
+void k_jobs_remove(pcb* proc) {
+  PIDSearchAndDelete(stopped_jobs, proc->pid);
+  PIDSearchAndDelete(background_jobs, proc->pid);
+  leave_group(proc);
+  update_plus();
+}
+
+void k_pgrp_join(pcb* proc, pid_t pgid) {
+  pcb* member = first_member(pgid);
+  PIDDeque* members = PIDIndex_Get(groups, pgid);
+  if (members == NULL) {
+    members = PIDDeque_Allocate();
+    PIDIndex_Put(groups, pgid, members);
+  }
+  PIDDeque_Push_Back(members, proc->pid);
+  proc->pgid = pgid;
+  proc->job_id = member != NULL ? member->job_id : 0;
+}
+
+int k_setpgid(pid_t pid, pid_t pgid) {
+  pcb* proc = PCBDequeJobSearch(PCBList, pid);
+  if (proc == NULL || pgid < 0) {
+    return -1;
+  }
+  if (pgid == 0) {
+    pgid = pid;
+  }
+  // a process can only start its own group or join one that exists
+  if (pgid != pid && PIDIndex_Get(groups, pgid) == NULL) {
+    return -1;
+  }
+  if (proc->pgid != pgid) {
+    leave_group(proc);
+    k_pgrp_join(proc, pgid);
+  }
+  return 0;
+}
+
+pid_t k_getpgid(pid_t pid) {
+  pcb* proc = PCBDequeJobSearch(PCBList, pid);
+  return proc != NULL ? proc->pgid : -1;
+}
+
+PIDDeque* k_pgrp_members(pid_t pgid) {
+  return PIDIndex_Get(groups, pgid);
+}
+
+int k_killpg(pid_t pgid, int signal) {
+  PIDDeque* members = PIDIndex_Get(groups, pgid);
+  if (members == NULL) {
+    return -1;
+  }
+  // signals never unlink members (that waits for cleanup), so the walk is safe
+  int delivered = 0;
+  pid_t pid;
+  for (uint32_t it = PIDDeque_Begin(members);
+       PIDDeque_Next(members, &it, &pid);) {
+    if (k_send_signal(pid, signal) == 0) {
+      delivered++;
+    }
+  }
+  return delivered > 0 ? 0 : -1;
+}
+
+void k_pgrp_continue(pid_t pgid) {
+  PIDDeque* members = PIDIndex_Get(groups, pgid);
+  if (members == NULL) {
+    return;
+  }
+  pid_t pid;
+  for (uint32_t it = PIDDeque_Begin(members);
+       PIDDeque_Next(members, &it, &pid);) {
+    pcb* member = PCBDequeJobSearch(PCBList, pid);
+    if (member != NULL && member->status == STATUS_STOPPED) {
+      k_send_signal(member->pid, P_SIGCONT);
+    }
+  }
+}
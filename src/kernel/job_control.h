@@ -0,0 +1,141 @@
+#ifndef JOB_CONTROL_H
+#define JOB_CONTROL_H
+
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Job control bookkeeping. Keeps a stack of stopped jobs (most recently
+// stopped on top) and a list of background jobs (most recently backgrounded
+// last), updated on every job control transition, so that the current job
+// (plus_pid) and the default target of fg/bg are found in O(1).
+//
+// Also keeps the job table, which maps job ids to process groups. Ids are
+// compact: a new job takes the lowest id not in use, and an id is freed when
+// the last process of its group is cleaned up, so a job outlives its leader
+// while other members of the group are alive.
+//
+// Every process belongs to a process group, by default its parent's. Each of
+// the shell's jobs starts its own group, so signals sent to the group reach
+// every process of the job. Each group keeps a list of its members, and a
+// process joining a group that is a job takes on its job id.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Allocates the job control lists. Called from k_allocate_lists.
+ */
+void k_jobs_init(void);
+
+/**
+ * @brief Frees the job control lists and the job table.
+ */
+void k_jobs_free(void);
+
+/**
+ * @brief Gives a process's group the lowest free job id, unless it already
+ * has one, and sets it on every member.
+ *
+ * @return the job id, or -1 if the table could not grow
+ */
+int k_jobs_assign(pcb* proc);
+
+/**
+ * @brief Looks up a job by job id: the leader of its group while it is
+ * alive, otherwise the oldest member left.
+ *
+ * @return the job, or NULL if no job has that id
+ */
+pcb* k_jobs_lookup(int job_id);
+
+/**
+ * @brief Writes one line per job in the table, in job id order, marking the
+ * current job with +.
+ */
+void k_jobs_print(int output_fd);
+
+/**
+ * @brief Records that a job is now running in the background, either because
+ * it was spawned with & or because it was stopped.
+ */
+void k_jobs_background(pcb* proc);
+
+/**
+ * @brief Records that a job was stopped. It becomes the top of the stopped
+ * stack and the most recent background job.
+ */
+void k_jobs_stopped(pcb* proc);
+
+/**
+ * @brief Records that a stopped job was continued (by bg or SIGCONT).
+ */
+void k_jobs_continued(pcb* proc);
+
+/**
+ * @brief Records that a job was brought to the foreground.
+ */
+void k_jobs_foreground(pcb* proc);
+
+/**
+ * @brief Forgets a process that is being cleaned up and removes it from its
+ * process group, freeing the group's job id if it was the last member.
+ */
+void k_jobs_remove(pcb* proc);
+
+/**
+ * @brief Returns the most recently stopped job still stopped.
+ *
+ * @return the job, or NULL if no job is stopped
+ */
+pcb* k_jobs_last_stopped(void);
+
+/**
+ * @brief Returns the current job: the most recently stopped job or, if none
+ * is stopped, the most recent background job.
+ *
+ * @return the job, or NULL if there is none
+ */
+pcb* k_jobs_current(void);
+
+/**
+ * @brief Adds a process that belongs to no group yet to group pgid, creating
+ * the group if needed. Called from k_proc_create.
+ */
+void k_pgrp_join(pcb* proc, pid_t pgid);
+
+/**
+ * @brief Moves a process into process group pgid. A pgid of 0 or equal to pid
+ * starts a new group led by the process.
+ *
+ * @return 0 on success, -1 if the process does not exist or pgid names a
+ * group that does not exist
+ */
+int k_setpgid(pid_t pid, pid_t pgid);
+
+/**
+ * @brief Returns the process group of a process.
+ *
+ * @return the pgid, or -1 if the process does not exist
+ */
+pid_t k_getpgid(pid_t pid);
+
+/**
+ * @brief Sends a signal to every member of a process group, in O(members).
+ *
+ * @return 0 if the signal reached at least one member, -1 otherwise
+ */
+int k_killpg(pid_t pgid, int signal);
+
+/**
+ * @brief Returns the members of a process group, front to back in the order
+ * they joined.
+ *
+ * @return the member list, or NULL if the group does not exist
+ */
+PIDDeque* k_pgrp_members(pid_t pgid);
+
+/**
+ * @brief Continues the stopped members of a process group. Used by fg and bg
+ * once the job itself has been resumed.
+ */
+void k_pgrp_continue(pid_t pgid);
+
+#endif
@@ -1,7 +1,25 @@
 #include "kernel.h"
 #include <stdio.h>
 #include <string.h>
+#include "../util/PCBSlab.h"
 #include "../util/parser.h"
+#include "aio.h"
+#include "cfs.h"
+#include "cgroup.h"
+#include "edf.h"
+#include "fdpoll.h"
+#include "job_control.h"
+#include "mq.h"
+#include "pidmap.h"
+#include "runqueue.h"
+#include "signal_queue.h"
+#include "schedstat.h"
+#include "shm.h"
+#include "sync.h"
+#include "trace.h"
+
+// Number of PCBs whose threads are torn down together in k_proc_cleanup
+#define CLEANUP_BATCH 64
 
 char* command_print_helper(char*** commands) {
   if (commands == NULL || *commands == NULL) {
@@ -39,16 +57,95 @@ char* command_print_helper(char*** commands) {
 
 void k_allocate_lists() {
   PCBList = PCBDeque_Allocate();
-  for (int i = 0; i < 4; i++) {
+  for (int i = 0; i <= INACTIVE_QUEUE; i++) {
     priorityList[i] = PIDDeque_Allocate();
   }
+  k_runqueue_init();
+  k_jobs_init();
+  k_signals_init();
+  k_cfs_init();
+  k_edf_init();
+  k_cgroup_init();
+  k_pid_init();
+  k_sync_init();
+  k_shm_init();
+  k_mq_init();
+  k_poll_init();
+  k_aio_init();
+}
+
+void k_free_lists() {
+  PCBDeque_FreeWithPCBs(PCBList);
+  PCBSlab_Free();
+  for (int i = 0; i <= INACTIVE_QUEUE; i++) {
+    PIDDeque_Free(priorityList[i]);
+  }
+  k_jobs_free();
+  k_signals_free();
+  k_cfs_free();
+  k_edf_free();
+  k_cgroup_free();
+  k_pid_free();
+  k_sync_free();
+  k_shm_free();
+  k_mq_free();
+  k_poll_free();
+  k_aio_free();
+}
+
+int k_run_level(pcb* proc) {
+  return proc->priority - proc->boost;
+}
+
+void k_enqueue_runnable(pcb* proc) {
+  k_runqueue_enqueue(proc);
+  proc->queued_tick = ticks;
+  k_schedstat_runnable(proc);
+}
+
+void k_dequeue_runnable(pcb* proc) {
+  k_runqueue_dequeue(proc);
+  proc->boost = 0;
+}
+
+void k_block(pcb* proc) {
+  proc->status = STATUS_BLOCKED;
+  k_dequeue_runnable(proc);
+  if (!PIDDequeJobSearch(priorityList[INACTIVE_QUEUE], proc->pid)) {
+    PIDDeque_Push_Back(priorityList[INACTIVE_QUEUE], proc->pid);
+  }
+  k_trace_event(TRACE_BLOCKED, proc);
+}
+
+void k_unblock(pcb* proc) {
+  if (!P_WIFBLOCKED(proc->status)) {
+    return;
+  }
+  proc->status = STATUS_RUNNING;
+  PIDSearchAndDelete(priorityList[INACTIVE_QUEUE], proc->pid);
+  k_enqueue_runnable(proc);
+  k_trace_event(TRACE_UNBLOCKED, proc);
+}
+
+// Called when proc has finished or been terminated: queues it for its parent
+// to reap and wakes the parent if it is blocked waiting for any child.
+static void notify_parent(pcb* proc, pcb* parent) {
+  if (parent == NULL) {
+    return;
+  }
+  PIDDeque_Push_Back(parent->ready_children, proc->pid);
+  if (parent->waiting_any) {
+    k_unblock(parent);
+  }
 }
 
 // Helper to intialize fdt for process to relevant values
 void initialize_fdt(pcb* proc, int file_in, int file_out) {
+  proc->process_fdt = proc->fdt_inline;
+  proc->fdt_size = PCB_FDT_INLINE;
   proc->process_fdt[0] = file_in;
   proc->process_fdt[1] = file_out;
-  for (int i = 2; i < 1024; i++) {
+  for (int i = 2; i < PCB_FDT_INLINE; i++) {
     proc->process_fdt[i] = -1;
   }
 }
@@ -60,14 +157,18 @@ pcb* k_proc_create(pcb* parent,
                    char* process_name,
                    bool is_background,
                    struct parsed_command* parsed) {
+  pid_t pid = k_pid_alloc();
+  if (pid == -1) {
+    return NULL;
+  }
   // create child PCB
-  pcb* child = malloc(sizeof(pcb));
-  child->pid = pidCount;
+  pcb* child = PCBSlab_Get();
+  child->pid = pid;
   child->status = STATUS_RUNNING;
   child->parent_pid = parent != NULL ? parent->pid : -1;
   child->curr_thread = curr_thread;
   child->child_pids = PIDDeque_Allocate();
-  child->status_changes = PIDDeque_Allocate();
+  child->ready_children = PIDDeque_Allocate();
   child->priority = 1;
   child->blocking = is_background ? 0 : 1;
   child->sleep_duration = -1;
@@ -76,22 +177,38 @@ pcb* k_proc_create(pcb* parent,
   child->is_background = is_background;
   child->parsed = parsed;
   child->job_id = 0;
+  child->waiting_any = false;
+  child->boost = 0;
+  child->vruntime = 0;
+  child->rt_period = child->rt_budget = child->rt_left = 0;
+  child->rt_deadline = child->rt_misses = 0;
+  atomic_init(&child->pending_signals, 0);
   initialize_fdt(child, fd0, fd1);
+  k_cgroup_join(child, parent != NULL ? parent->cgroup : CGROUP_ROOT);
 
   // include child PCB in child_pids
   if (parent != NULL) {
     PIDDeque_Push_Back(parent->child_pids, child->pid);
   }
   // put in prioirty list
-  PIDDeque_Push_Back(priorityList[child->priority], child->pid);
+  k_enqueue_runnable(child);
   PCBDeque_Push_Back(PCBList, child);
-  // update global PID Count
-  pidCount++;
+  // each of the shell's jobs starts out as its own process group, so the
+  // job table can key it by group from the start
+  k_pgrp_join(child, parent != NULL && parent->pid != 1 ? parent->pgid
+                                                         : child->pid);
+  // a foreground job owns ^C and ^Z from now on, not from its first tick
+  if (!is_background && child->parent_pid == 1) {
+    fgJob = child->pid;
+  }
+  if (is_background) {
+    k_jobs_background(child);
+  }
 
   // print out job number and pid in [1] 34234 format
   if (is_background && child->parent_pid == 1) {
     char announcement[1024];
-    child->job_id = ++num_bg_jobs;
+    k_jobs_assign(child);
     sprintf(announcement, "[%d] %d\n", child->job_id, child->pid);
     k_write(1, announcement, strlen(announcement));
   }
@@ -121,10 +238,7 @@ int k_send_signal(pid_t pid, int signal) {  // if parent is killed, should
     if (strcmp(proc->process_name, "sleep") == 0) {
       newStatus = STATUS_BLOCKED;
     }
-    char message[100];
-    sprintf(message, "[%3d]\tCONTINUED\t%d\t%d\t%-15s\n", ticks, proc->pid,
-            proc->priority, proc->process_name);
-    k_write_log(message);
+    k_trace_event(TRACE_CONTINUED, proc);
     if (proc->parent_pid == 1) {
       char announcement[1024];
       char plus = (proc->pid == plus_pid) ? '+' : ' ';
@@ -132,14 +246,13 @@ int k_send_signal(pid_t pid, int signal) {  // if parent is killed, should
               proc->pid, command_print_helper((proc->parsed)->commands));
       k_write(STDOUT_FILENO, announcement, strlen(announcement));
     }
+    k_jobs_continued(proc);
   } else if (signal == P_SIGSTOP) {
     newStatus = STATUS_STOPPED;
     proc->stop_time = ticks;
     proc->is_background = true;
     if (proc->parent_pid == 1) {
-      if (proc->job_id == 0) {
-        proc->job_id = ++num_bg_jobs;
-      }
+      k_jobs_assign(proc);
       char announcement[1024];
       sprintf(announcement, "[%d]+ %d suspended %s\n", proc->job_id, proc->pid,
               command_print_helper((proc->parsed)->commands));
@@ -148,38 +261,30 @@ int k_send_signal(pid_t pid, int signal) {  // if parent is killed, should
     // move recently stopped jobs to back of list;
     PCBSearchAndDelete(PCBList, proc->pid, false);
     PCBDeque_Push_Back(PCBList, proc);
+    k_jobs_stopped(proc);
 
-    char message[100];
-    sprintf(message, "[%3d]\tSTOPPED  \t%d\t%d\t%-15s\n", ticks, proc->pid,
-            proc->priority, proc->process_name);
-    k_write_log(message);
+    k_trace_event(TRACE_STOPPED, proc);
   } else if (signal == P_SIGTERM) {
     newStatus = STATUS_TERMINATED;
-    char message[100];
-    sprintf(message, "[%3d]\tSIGNALED \t%d\t%d\t%-15s\n", ticks, proc->pid,
-            proc->priority, proc->process_name);
-    k_write_log(message);
+    k_trace_event(TRACE_SIGNALED, proc);
+    k_sync_forget(proc);
+    k_mq_forget(proc);
+    k_poll_forget(proc);
+    k_aio_forget(proc);
 
     if (proc->parent_pid != -1) {
-      char message[100];
-      sprintf(message, "[%3d]\tZOMBIE   \t%d\t%d\t%-15s\n", ticks, proc->pid,
-              proc->priority, proc->process_name);
-      k_write_log(message);
+      k_trace_event(TRACE_ZOMBIE, proc);
     }
 
     PIDDeque* children = proc->child_pids;
-    PIDDqNode* head = children->front;
-    while (head != NULL) {
-      pcb* child_proc = PCBDequeJobSearch(PCBList, head->pid);
-      if (child_proc == NULL) {
-        head = head->next;
-        continue;
+    pid_t child_pid;
+    for (uint32_t it = PIDDeque_Begin(children);
+         PIDDeque_Next(children, &it, &child_pid);) {
+      pcb* child_proc = PCBDequeJobSearch(PCBList, child_pid);
+      if (child_proc != NULL) {
+        k_trace_event(TRACE_ORPHAN, child_proc);
+        break;
       }
-      char message[100];
-      sprintf(message, "[%3d]\tORPHAN   \t%d\t%d\t%-15s\n", ticks,
-              child_proc->pid, child_proc->priority, child_proc->process_name);
-      k_write_log(message);
-      break;
     }
 
     if (proc->is_background && proc->parent_pid == 1) {
@@ -198,33 +303,28 @@ int k_send_signal(pid_t pid, int signal) {  // if parent is killed, should
     // update status of current pid to signal value
     proc->status = newStatus;
     // previously a suspended, waiting, or
-    // stopped process (in priorityList[3])
+    // stopped process (in priorityList[INACTIVE_QUEUE])
     if (P_WIFRUNNING(newStatus)) {
-      PIDSearchAndDelete(priorityList[3], pid);
-      PIDDeque_Push_Back(priorityList[proc->priority], pid);
+      PIDSearchAndDelete(priorityList[INACTIVE_QUEUE], pid);
+      k_enqueue_runnable(proc);
       // previously running, now stopped or terminated
     } else if ((P_WIFSTOPPED(newStatus) || P_WIFSIGNALED(newStatus)) &&
-               !PIDDequeJobSearch(priorityList[3], pid)) {
-      PIDSearchAndDelete(priorityList[proc->priority], pid);
-      PIDDeque_Push_Back(priorityList[3], pid);
+               !PIDDequeJobSearch(priorityList[INACTIVE_QUEUE], pid)) {
+      k_dequeue_runnable(proc);
+      PIDDeque_Push_Back(priorityList[INACTIVE_QUEUE], pid);
     }
-    // update parent's status_change deque with recent status change
     pcb* parent = PCBDequeJobSearch(PCBList, proc->parent_pid);
-    PIDDeque_Push_Back(parent->status_changes, pid);
+    if (P_WIFSIGNALED(newStatus)) {
+      notify_parent(proc, parent);
+    }
 
     // update parent if i was blocking and am now running (parent should no
     // longer be inactive)
-    if (proc->blocking && !P_WIFRUNNING(proc->status)) {
+    if (proc->blocking && !P_WIFRUNNING(proc->status) && parent != NULL) {
       if (proc->status == STATUS_STOPPED) {
         proc->blocking = false;
       }
-      parent->status = STATUS_RUNNING;
-      PIDSearchAndDelete(priorityList[3], parent->pid);
-      PIDDeque_Push_Back(priorityList[parent->priority], parent->pid);
-      char message[100];
-      sprintf(message, "[%3d]\tUNBLOCKED\t%d\t%d\t%-15s\n", ticks, parent->pid,
-              parent->priority, parent->process_name);
-      k_write_log(message);
+      k_unblock(parent);
     }
   }
   return 0;
@@ -243,174 +343,123 @@ int k_change_priority(pid_t pid, int priority) {
 
   // in running state, it is in a priority list, move to next priority list
   if (P_WIFRUNNING(proc->status)) {
-    PIDSearchAndDelete(priorityList[proc->priority], pid);
-    PIDDeque_Push_Back(priorityList[priority], pid);
+    k_dequeue_runnable(proc);
   }
 
-  char message[100];
-  sprintf(message, "[%3d]\tNICE     \t%d\t%d\t%d\t%-15s\n", ticks, proc->pid,
-          proc->priority, priority, proc->process_name);
-  k_write_log(message);
+  k_trace_event_ext(TRACE_NICE, proc, proc->priority, priority);
 
   // change priority level in PCB
   proc->priority = priority;
+  if (P_WIFRUNNING(proc->status)) {
+    k_runqueue_enqueue(proc);
+  }
   return 0;
 }
 
+int k_sched_setattr(pid_t pid, int period, int budget) {
+  pcb* proc = PCBDequeJobSearch(PCBList, pid);
+  if (proc == NULL || P_WIFEXITED(proc->status) ||
+      P_WIFSIGNALED(proc->status)) {
+    return -1;
+  }
+  // the running job is in no queue and is put back after its tick
+  bool queued = P_WIFRUNNING(proc->status) && pid != currentJob;
+  if (queued) {
+    k_dequeue_runnable(proc);
+  }
+  int res = k_edf_setattr(proc, period, budget);
+  if (queued) {
+    k_runqueue_enqueue(proc);
+  }
+  return res;
+}
+
 void k_exit() {  // if parent is killed, automatically kill children??
   pcb* proc = PCBDequeJobSearch(PCBList, currentJob);
   // job is in running state, move to inactive
   if (P_WIFRUNNING(proc->status)) {
-    PIDSearchAndDelete(priorityList[proc->priority], proc->pid);
-    PIDDeque_Push_Back(priorityList[3], proc->pid);
+    k_dequeue_runnable(proc);
+    PIDDeque_Push_Back(priorityList[INACTIVE_QUEUE], proc->pid);
   }
   // set status to finished
   proc->status = STATUS_FINISHED;
+  k_sync_forget(proc);
+  k_mq_forget(proc);
+  k_poll_forget(proc);
+  k_aio_forget(proc);
 
-  // inform parent via an update to status_changed
-  pcb* parent = PCBDequeJobSearch(PCBList, proc->parent_pid);
-  if (parent != NULL) {
-    PIDDeque_Push_Back(parent->status_changes, proc->pid);
-  }
-
-  char message[100];
-  sprintf(message, "[%3d]\tEXITED   \t%d\t%d\t%-15s\n", ticks, proc->pid,
-          proc->priority, proc->process_name);
-  k_write_log(message);
+  k_trace_event(TRACE_EXITED, proc);
 
   if (proc->parent_pid != -1) {
-    char message[100];
-    sprintf(message, "[%3d]\tZOMBIE   \t%d\t%d\t%-15s\n", ticks, proc->pid,
-            proc->priority, proc->process_name);
-    k_write_log(message);
+    k_trace_event(TRACE_ZOMBIE, proc);
   }
 
   PIDDeque* children = proc->child_pids;
-  PIDDqNode* head = children->front;
-  while (head != NULL) {
-    pcb* child_proc = PCBDequeJobSearch(PCBList, head->pid);
-    if (child_proc == NULL) {
-      head = head->next;
-      continue;
+  pid_t child_pid;
+  for (uint32_t it = PIDDeque_Begin(children);
+       PIDDeque_Next(children, &it, &child_pid);) {
+    pcb* child_proc = PCBDequeJobSearch(PCBList, child_pid);
+    if (child_proc != NULL) {
+      k_trace_event(TRACE_ORPHAN, child_proc);
+      break;
     }
-    char message[100];
-    sprintf(message, "[%3d]\tORPHAN   \t%d\t%d\t%-15s\n", ticks,
-            child_proc->pid, child_proc->priority, child_proc->process_name);
-    k_write_log(message);
-    break;
   }
 
+  // queue up for the parent to reap
+  pcb* parent = PCBDequeJobSearch(PCBList, proc->parent_pid);
+  notify_parent(proc, parent);
+
   // if curr process is blocking the parent, unstop the parent
   // move parent back to running state
-  if (proc->blocking) {
-    parent->status = STATUS_RUNNING;
-    if (PIDSearchAndDelete(priorityList[3], parent->pid)) {
-      PIDDeque_Push_Back(priorityList[parent->priority], parent->pid);
+  if (proc->blocking && parent != NULL) {
+    k_unblock(parent);
+  }
+}
+
+// Reaps a finished or terminated child of the calling process
+static pid_t reap_child(pcb* child, int* wstatus) {
+  if (wstatus != NULL) {
+    *wstatus = child->status;
+  }
+  pid_t to_return = child->pid;
+  k_trace_event(TRACE_WAITED, child);
+  k_proc_cleanup(child);
+  return to_return;
+}
+
+// Pops the oldest ready child off the parent's queue and reaps it
+static pid_t reap_ready_child(pcb* parent, int* wstatus) {
+  pid_t pid = -1;
+  while (PIDDeque_Pop_Front(parent->ready_children, &pid)) {
+    pcb* child = PCBDequeJobSearch(PCBList, pid);
+    if (child != NULL) {
+      return reap_child(child, wstatus);
     }
-    char message[100];
-    sprintf(message, "[%3d]\tUNBLOCKED\t%d\t%d\t%-15s\n", ticks, parent->pid,
-            parent->priority, parent->process_name);
-    k_write_log(message);
   }
+  return 0;
 }
 
 pid_t k_waitpid(pid_t pid, int* wstatus, bool nohang) {
+  pcb* parent = PCBDequeJobSearch(PCBList, currentJob);
+
   // Special case: wait on all children
   if (pid == -1) {
-    pcb* parent = PCBDequeJobSearch(PCBList, currentJob);
-    PIDDeque* children = parent->child_pids;
-
-    if (PIDDeque_Size(children) == 0) {
+    if (PIDDeque_Size(parent->child_pids) == 0) {
       return -1;
     }
 
-    if (!nohang) {
-      PIDDqNode* head = children->front;
-      while (head != NULL) {
-        pcb* child_proc = PCBDequeJobSearch(PCBList, head->pid);
-        child_proc->blocking = 1;
-        head = head->next;
-      }
-    }
-
-    PIDDqNode* head = children->front;
-    while (head != NULL) {
-      pcb* child_proc = PCBDequeJobSearch(PCBList, head->pid);
-      if (child_proc == NULL) {
-        head = head->next;
-        continue;
-      }
-      if (child_proc->status == STATUS_FINISHED ||
-          child_proc->status == STATUS_TERMINATED) {
-        if (wstatus != NULL) {
-          *wstatus = child_proc->status;
-        }
-        pid_t to_return = child_proc->pid;
-        char message[100];
-        sprintf(message, "[%3d]\tWAITED   \t%d\t%d\t%-15s\n", ticks,
-                child_proc->pid, child_proc->priority,
-                child_proc->process_name);
-        k_write_log(message);
-        k_handle_status_changes(child_proc->pid);
-
-        return to_return;
-      }
-      head = head->next;
+    pid_t reaped = reap_ready_child(parent, wstatus);
+    if (reaped > 0 || nohang) {
+      return reaped;
     }
 
-    if (!nohang) {
-      // set parent status to waiting
-      parent->status = STATUS_BLOCKED;
-
-      // move to inactive jobs queue and wait
-      PIDSearchAndDelete(priorityList[parent->priority], parent->pid);
-      if (!PIDDequeJobSearch(priorityList[3], parent->pid)) {
-        PIDDeque_Push_Back(priorityList[3], parent->pid);
-      }
-
-      PIDDqNode* head = children->front;
-      while (head != NULL) {
-        pcb* child_proc = PCBDequeJobSearch(PCBList, head->pid);
-        if (child_proc == NULL) {
-          head = head->next;
-          continue;
-        }
-        child_proc->blocking = 1;
-        head = head->next;
-      }
-
-      char message[100];
-      sprintf(message, "[%3d]\tBLOCKED  \t%d\t%d\t%-15s\n", ticks, parent->pid,
-              parent->priority, parent->process_name);
-      k_write_log(message);
-
-      spthread_suspend(parent->curr_thread);
-    }
-
-    head = children->front;
-    while (head != NULL) {
-      pcb* child_proc = PCBDequeJobSearch(PCBList, head->pid);
-      if (child_proc == NULL) {
-        continue;
-      }
-      if (child_proc->status == STATUS_FINISHED ||
-          child_proc->status == STATUS_TERMINATED) {
-        if (wstatus != NULL) {
-          *wstatus = child_proc->status;
-        }
+    // block until a child makes itself ready, it wakes us up directly
+    parent->waiting_any = true;
+    k_block(parent);
+    spthread_suspend(parent->curr_thread);
+    parent->waiting_any = false;
 
-        pid_t to_return = child_proc->pid;
-        char message[100];
-        sprintf(message, "[%3d]\tWAITED   \t%d\t%d\t%-15s\n", ticks,
-                child_proc->pid, child_proc->priority,
-                child_proc->process_name);
-        k_write_log(message);
-        k_handle_status_changes(child_proc->pid);
-        return to_return;
-      }
-      head = head->next;
-    }
-    return 0;
+    return reap_ready_child(parent, wstatus);
   }
 
   // Specified pid
@@ -421,52 +470,35 @@ pid_t k_waitpid(pid_t pid, int* wstatus, bool nohang) {
     return -1;
   }
 
-  pcb* parent = PCBDequeJobSearch(PCBList, currentJob);
   // error case 2: pid is not a child process of the calling parent
-  if (!PIDDequeJobSearch(parent->child_pids, pid)) {
+  if (child_proc->parent_pid != parent->pid) {
     return -1;
   }
 
   if (child_proc->status == STATUS_FINISHED ||
       child_proc->status == STATUS_TERMINATED) {
-    if (wstatus != NULL) {
-      *wstatus = child_proc->status;
-    }
-
-    pid_t to_return = child_proc->pid;
-    char message[100];
-    sprintf(message, "[%3d]\tWAITED   \t%d\t%d\t%-15s\n", ticks,
-            child_proc->pid, child_proc->priority, child_proc->process_name);
-    k_write_log(message);
-    k_handle_status_changes(child_proc->pid);
-    return to_return;
+    PIDSearchAndDelete(parent->ready_children, pid);
+    return reap_child(child_proc, wstatus);
   }
 
   if (!nohang) {
     // set parent status to waiting
-    parent->status = STATUS_BLOCKED;
-    PIDSearchAndDelete(priorityList[parent->priority], parent->pid);
-    if (!PIDDequeJobSearch(priorityList[3], parent->pid)) {
-      PIDDeque_Push_Back(priorityList[3], parent->pid);
-    }
+    k_block(parent);
     // the child sets blocking to true
     child_proc->blocking = 1;
 
-    char message[100];
-    sprintf(message, "[%3d]\tBLOCKED  \t%d\t%d\t%-15s\n", ticks, parent->pid,
-            parent->priority, parent->process_name);
-    k_write_log(message);
-
     spthread_suspend(parent->curr_thread);
   }
   if (wstatus != NULL) {
     *wstatus = child_proc->status;
   }
-  char message[100];
-  sprintf(message, "[%3d]\tWAITED   \t%d\t%d\t%-15s\n", ticks, child_proc->pid,
-          child_proc->priority, child_proc->process_name);
-  k_write_log(message);
-  k_handle_status_changes(child_proc->pid);
+  // woken up either because the child is done or because it stopped
+  if (child_proc->status == STATUS_FINISHED ||
+      child_proc->status == STATUS_TERMINATED) {
+    PIDSearchAndDelete(parent->ready_children, pid);
+    return reap_child(child_proc, wstatus);
+  }
+  k_trace_event(TRACE_WAITED, child_proc);
   return pid;
 }
 
@@ -479,13 +511,10 @@ void k_sleep(unsigned int seconds) {
   proc->status = STATUS_BLOCKED;
   proc->sleep_duration = seconds * 10;
   // move to inactive jobs list
-  PIDSearchAndDelete(priorityList[proc->priority], proc->pid);
-  PIDDeque_Push_Back(priorityList[3], proc->pid);
+  k_dequeue_runnable(proc);
+  PIDDeque_Push_Back(priorityList[INACTIVE_QUEUE], proc->pid);
 
-  char message[100];
-  sprintf(message, "[%3d]\tBLOCKED  \t%d\t%d\t%-15s\n", ticks, proc->pid,
-          proc->priority, proc->process_name);
-  k_write_log(message);
+  k_trace_event(TRACE_BLOCKED, proc);
   return;
 }
 
@@ -502,44 +531,75 @@ void k_proc_cleanup(pcb* proc) {
     k_write(STDOUT_FILENO, message, strlen(message));
   }
 
-  PIDDeque* children = proc->child_pids;
-  // remove from the priority list
-  PIDSearchAndDelete(priorityList[proc->priority], proc->pid);
-  PIDSearchAndDelete(priorityList[3], proc->pid);
-  pid_t curr_child = -1;
-  // recursively clean up children a well
-  while (PIDDeque_Peek_Front(children, &curr_child)) {
-    pcb* child_proc = PCBDequeJobSearch(PCBList, curr_child);
-    k_proc_cleanup(child_proc);
-    PIDDeque_Pop_Front(children);
-  }
-
   // Have to remove from parent's child list
   if (proc->parent_pid != -1) {
     pcb* parent = PCBDequeJobSearch(PCBList, proc->parent_pid);
-    PIDDeque* parent_children = parent->child_pids;
-    PIDSearchAndDelete(parent_children, proc->pid);
+    PIDSearchAndDelete(parent->child_pids, proc->pid);
+    PIDSearchAndDelete(parent->ready_children, proc->pid);
 
     // Move parent back into active queue if it was blocking
     if (proc->blocking &&
-        PIDDequeJobSearch(priorityList[3], proc->parent_pid)) {
-      PIDSearchAndDelete(priorityList[3], proc->parent_pid);
-      PIDDeque_Push_Back(priorityList[parent->priority], parent->pid);
+        PIDDequeJobSearch(priorityList[INACTIVE_QUEUE], proc->parent_pid)) {
+      PIDSearchAndDelete(priorityList[INACTIVE_QUEUE], proc->parent_pid);
+      k_enqueue_runnable(parent);
     }
   }
 
-  PCBSearchAndDelete(PCBList, proc->pid, true);
-  return;
+  // Unlink proc and every descendant breadth first using an explicit
+  // worklist, so deep process trees cannot overflow the stack. Descendants
+  // don't need detaching from their parents since those go too.
+  int capacity = 16;
+  int count = 1;
+  pcb** worklist = malloc(capacity * sizeof(pcb*));
+  worklist[0] = proc;
+  for (int i = 0; i < count; i++) {
+    pcb* curr = worklist[i];
+    pid_t child_pid;
+    for (uint32_t it = PIDDeque_Begin(curr->child_pids);
+         PIDDeque_Next(curr->child_pids, &it, &child_pid);) {
+      pcb* child_proc = PCBDequeJobSearch(PCBList, child_pid);
+      if (child_proc == NULL) {
+        continue;
+      }
+      if (count == capacity) {
+        capacity *= 2;
+        worklist = realloc(worklist, capacity * sizeof(pcb*));
+      }
+      worklist[count++] = child_proc;
+    }
+    // remove from the priority list
+    k_dequeue_runnable(curr);
+    PIDSearchAndDelete(priorityList[INACTIVE_QUEUE], curr->pid);
+    PCBSearchAndDelete(PCBList, curr->pid, false);
+    k_jobs_remove(curr);
+    // a group that outlives its leader keeps the leader's pid as its pgid
+    if (k_pgrp_members(curr->pid) == NULL) {
+      k_pid_release(curr->pid);
+    }
+    k_signals_forget(curr);
+    k_edf_forget(curr);
+    k_sync_forget(curr);
+    k_mq_forget(curr);
+    k_poll_forget(curr);
+    k_aio_forget(curr);
+    k_shm_forget(curr);
+    k_cgroup_leave(curr);
+  }
+
+  for (int i = 0; i < count; i += CLEANUP_BATCH) {
+    int batch = count - i < CLEANUP_BATCH ? count - i : CLEANUP_BATCH;
+    PCBDeque_FreePCBs(worklist + i, batch);
+  }
+  free(worklist);
 }
 
 void k_sleep_check() {
   // iterate the inactive job queue
-  PIDDeque* inactives = priorityList[3];
+  PIDDeque* inactives = priorityList[INACTIVE_QUEUE];
   pid_t pid = -1;
-  // recursively clean up children a well
-  PIDDqNode* curr = inactives->front;
-  while (curr != NULL) {
-    pid = curr->pid;
+  // unblocking a parent removes it from the queue, which the cursor survives
+  for (uint32_t it = PIDDeque_Begin(inactives);
+       PIDDeque_Next(inactives, &it, &pid);) {
     pcb* proc = PCBDequeJobSearch(PCBList, pid);
     if (proc->sleep_duration > 0 &&
         proc->status == STATUS_BLOCKED) {  // it is a sleeping job
@@ -547,51 +607,21 @@ void k_sleep_check() {
       if (proc->sleep_duration == 0) {  // if sleep count reaches 0, unsleep and
                                         // change status to finished
         proc->status = STATUS_FINISHED;  // set status to finished
-        // inform parent via an update to status_changed
+        // queue up for the parent to reap
         pcb* parent = PCBDequeJobSearch(PCBList, proc->parent_pid);
-        if (parent != NULL) {
-          PIDDeque_Push_Back(parent->status_changes, pid);
-        }
+        notify_parent(proc, parent);
         // if curr process is blocking the parent, unstop the parent
         // move parent back to running state
-        if (proc->blocking) {
-          parent->status = STATUS_RUNNING;
-          PIDSearchAndDelete(priorityList[3], parent->pid);
-          PIDDeque_Push_Back(priorityList[parent->priority], parent->pid);
+        if (proc->blocking && parent != NULL) {
+          k_unblock(parent);
         }
       }
     }
-    curr = curr->next;
   }
 }
 
-void k_handle_status_changes(pid_t target_pid) {
-  // for now, just handle finished jobs by calling k_proc_cleanup
-  pcb* proc = PCBDequeJobSearch(PCBList, currentJob);
-  PIDDeque* stat_changes = proc->status_changes;
-  pid_t job = -1;
-
-  PIDDqNode* curr = stat_changes->front;
-  while (curr != NULL) {
-    job = curr->pid;
-    pcb* changed_job = PCBDequeJobSearch(PCBList, job);
-    if (changed_job == NULL) {
-      curr = curr->next;
-      continue;
-    }
-    curr = curr->next;
-    if (changed_job->pid == target_pid &&
-        (changed_job->status == STATUS_FINISHED ||
-         changed_job->status == STATUS_TERMINATED)) {
-      k_proc_cleanup(changed_job);
-      PIDSearchAndDelete(stat_changes, job);
-    }
-  }
-  return;
-}
-
 void k_write_log(char* message) {
-  write(logfd, message, strlen(message));
+  k_trace_text(message);
 }
 
 /**
@@ -604,31 +634,39 @@ void k_write_log(char* message) {
 */
 void k_ps() {
   // write header to stdout
-  char* header = "PID\tPPID\tPRI\tSTAT\tCMD\n";
+  char* header = "PID\tPPID\tPGID\tPRI\tSTAT\tCMD\n";
 
   pcb* curr_job = PCBDequeJobSearch(PCBList, currentJob);
 
   k_write(curr_job->process_fdt[1], header, strlen(header) + 1);
 
-  PCBDqNode* curr_node = PCBList->front;
-  while (curr_node != NULL) {
-    pcb* proc = curr_node->pcb;
+  pcb* proc;
+  for (uint32_t it = PCBDeque_Begin(PCBList);
+       PCBDeque_Next(PCBList, &it, &proc);) {
     char message[100];
+    // a job raised by aging shows the level it waits at, marked with *
+    char priority[8];
+    if (proc->rt_period > 0) {
+      sprintf(priority, "RT");
+    } else if (proc->boost > 0) {
+      sprintf(priority, "%d*", k_run_level(proc));
+    } else {
+      sprintf(priority, "%d", proc->priority);
+    }
     // fill message up with each process id info, inshallah it does not overflow
-    sprintf(message, "%d\t%d\t%d\t%s\t%s\n", proc->pid, proc->parent_pid,
-            proc->priority, get_status(proc->status), proc->process_name);
+    sprintf(message, "%d\t%d\t%d\t%s\t%s\t%s\n", proc->pid, proc->parent_pid,
+            proc->pgid, priority, get_status(proc->status), proc->process_name);
     k_write(curr_job->process_fdt[1], message, strlen(message) + 1);
-    curr_node = curr_node->next;
   }
 }
 
-int k_handle_bg(pid_t pid) {
+int k_handle_bg(int job_id) {
   // curr_job is pcd of either most recently stopped job or backgrounded job
   pcb* curr_job = NULL;
-  if (pid == -1) {
-    curr_job = PCBDequeStopSearch(PCBList);
+  if (job_id == -1) {
+    curr_job = k_jobs_last_stopped();
   } else {
-    curr_job = PCBDequeJobSearch(PCBList, pid);
+    curr_job = k_jobs_lookup(job_id);
   }
   // job doesn't exist, or job is not stopped,
   if (curr_job == NULL || curr_job->status != STATUS_STOPPED ||
@@ -640,12 +678,14 @@ int k_handle_bg(pid_t pid) {
   curr_job->stop_time = 0;
   // remove from inactive queue if inactive
   if (!is_sleep) {
-    PIDSearchAndDelete(priorityList[3], curr_job->pid);
-    // add to priority list if it's not there
-    if (!PIDDequeJobSearch(priorityList[curr_job->priority], curr_job->pid)) {
-      PIDDeque_Push_Back(priorityList[curr_job->priority], curr_job->pid);
+    PIDSearchAndDelete(priorityList[INACTIVE_QUEUE], curr_job->pid);
+    // add to the run queues if it's not there
+    if (!k_runqueue_contains(curr_job)) {
+      k_enqueue_runnable(curr_job);
     }
   }
+  k_jobs_continued(curr_job);
+  k_pgrp_continue(curr_job->pgid);
   // inform the parent
   char message[1024];
   // fill message up with each process id info, inshallah it does not overflow
@@ -655,16 +695,13 @@ int k_handle_bg(pid_t pid) {
   return 0;
 }
 
-int k_handle_fg(pid_t pid) {
+int k_handle_fg(int job_id) {
   // curr_job is pcd of either most recently stopped job or backgrounded job
   pcb* curr_job = NULL;
-  if (pid == -1) {
-    curr_job = PCBDequeStopSearch(PCBList);
-    if (curr_job == NULL) {
-      curr_job = PCBDequeBackgroundSearch(PCBList);
-    }
+  if (job_id == -1) {
+    curr_job = k_jobs_current();
   } else {
-    curr_job = PCBDequeJobSearch(PCBList, pid);
+    curr_job = k_jobs_lookup(job_id);
   }
   if (curr_job == NULL || curr_job->status == STATUS_FINISHED ||
       curr_job->status == STATUS_TERMINATED) {
@@ -677,20 +714,22 @@ int k_handle_fg(pid_t pid) {
   curr_job->stop_time = 0;
   curr_job->blocking = true;
   fgJob = curr_job->pid;
+  k_jobs_foreground(curr_job);
+  k_pgrp_continue(curr_job->pgid);
 
   pcb* parent = PCBDequeJobSearch(PCBList, curr_job->parent_pid);
 
   // remove from inactive queue if inactive
   if (!is_sleep) {
-    PIDSearchAndDelete(priorityList[3], curr_job->pid);
-    // add to priority list if it's not there
-    if (!PIDDequeJobSearch(priorityList[curr_job->priority], curr_job->pid)) {
-      PIDDeque_Push_Back(priorityList[curr_job->priority], curr_job->pid);
+    PIDSearchAndDelete(priorityList[INACTIVE_QUEUE], curr_job->pid);
+    // add to the run queues if it's not there
+    if (!k_runqueue_contains(curr_job)) {
+      k_enqueue_runnable(curr_job);
     }
   }
   parent->status = STATUS_BLOCKED;
-  PIDSearchAndDelete(priorityList[parent->priority], parent->pid);
-  PIDDeque_Push_Back(priorityList[3], parent->pid);
+  k_dequeue_runnable(parent);
+  PIDDeque_Push_Back(priorityList[INACTIVE_QUEUE], parent->pid);
 
   char message[1024];
   sprintf(message, "[%d] %d running %s\n", curr_job->job_id, curr_job->pid,
@@ -11,12 +11,43 @@
 
 char* command_print_helper(char*** commands);
 void k_allocate_lists(void);  // allocates all deques
+void k_free_lists(void);      // frees all deques and the PCBs in them
+
+/**
+ * @brief Pushes a job onto the back of the queue for its priority and records
+ * the time it became runnable. Use for every transition into a runnable state.
+ */
+void k_enqueue_runnable(pcb* proc);
+
+/**
+ * @brief Removes a job from the run queue it waits in and drops any aging
+ * boost, which only lasts for one wait.
+ */
+void k_dequeue_runnable(pcb* proc);
+
+/**
+ * @brief Returns the run queue a job waits in: its priority, raised by any
+ * aging boost.
+ */
+int k_run_level(pcb* proc);
+
+/**
+ * @brief Marks a job as blocked and moves it to the inactive queue. The caller
+ * is responsible for suspending its thread.
+ */
+void k_block(pcb* proc);
+
+/**
+ * @brief Moves a blocked job back into the queue for its priority. Does
+ * nothing if the job is not blocked.
+ */
+void k_unblock(pcb* proc);
 
 /**
  * @brief Create a new child process, inheriting applicable properties from the
  * parent.
  *
- * @return Reference to the child PCB.
+ * @return Reference to the child PCB, or NULL if no PID is free.
  */
 pcb* k_proc_create(pcb* parent,
                    spthread_t thread,
@@ -48,9 +79,21 @@ int k_send_signal(pid_t pid, int signal);
 int k_change_priority(pid_t pid, int priority);
 
 /**
- * @brief Wait on child of the calling process.
+ * @brief Sets the real-time period and budget of a pid (see edf.h), moving
+ * it between the real-time class and its priority level if it is runnable.
+ *
+ * @return Returns 0 on success, -1 if the pid does not exist, is done or
+ * cannot be admitted.
+ */
+int k_sched_setattr(pid_t pid, int period, int budget);
+
+/**
+ * @brief Wait on child of the calling process. With pid -1 the oldest child
+ * on the caller's ready queue is reaped in O(1); if there is none the caller
+ * blocks until a child exits or is terminated and wakes it.
  *
- * @return Returns pid_of child, -1 on failure.
+ * @return Returns pid_of child, 0 if nohang and no child is ready, -1 on
+ * failure.
  */
 pid_t k_waitpid(pid_t pid, int* wstatus, bool nohang);
 
@@ -70,7 +113,8 @@ void k_sleep(unsigned int ticks);
 
 /**
  * @brief Clean up a terminated/finished thread's resources.
- * This may include freeing the PCB, handling children, etc.
+ * This may include freeing the PCB, handling children, etc. The whole subtree
+ * of descendants is torn down iteratively, freeing PCBs in batches.
  */
 void k_proc_cleanup(pcb* proc);
 
@@ -83,14 +127,8 @@ void k_proc_cleanup(pcb* proc);
 void k_sleep_check(void);
 
 /**
- * @brief Helper function called within waitpid, used to handle a status change
- * of the job specified in target_pid, calls k_proc_cleanup if necessary.
- * @return nothing
- */
-void k_handle_status_changes(pid_t target_pid);
-
-/**
- * @brief Function which writes status updates to the log file.
+ * @brief Function which writes a free-form message to the log. Scheduling
+ * events are recorded with k_trace_event instead.
  * @return nothing
  */
 void k_write_log(char* message);
@@ -109,17 +147,17 @@ void k_ps();
 char* get_status(int status);
 
 /**
- * @brief Function which handles the 'bg' command on the specified pid. If no
- * pid is provided to bg, the input to k_handle_bg is -1.
+ * @brief Function which handles the 'bg' command on the specified job id. If
+ * no job is provided to bg, the input to k_handle_bg is -1.
  * @return 0 on success, -1 on error
  */
-int k_handle_bg(pid_t pid);
+int k_handle_bg(int job_id);
 
 /**
- * @brief Function which handles the 'fg' command on the specified pid. If no
- * pid is provided to fg, the input to k_handle_fg is -1.
+ * @brief Function which handles the 'fg' command on the specified job id. If
+ * no job is provided to fg, the input to k_handle_fg is -1.
  * @return 0 on success, -1 on error
  */
-int k_handle_fg(pid_t pid);
+int k_handle_fg(int job_id);
 
 #endif  // KERNEL_SYSTEM_H
@@ -1,4 +1,17 @@
 #include "./kernel_system.h"
+#include "./aging.h"
+#include "./aio.h"
+#include "./cgroup.h"
+#include "./fdpoll.h"
+#include "./job_control.h"
+#include "./pidmap.h"
+#include "./runqueue.h"
+#include "./schedstat.h"
+#include "./shm.h"
+#include "./sync.h"
+#include "./trace.h"
+#include "../util/PCBSlab.h"
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -12,6 +25,10 @@ pid_t s_spawn(void* (*func)(void*),
               char* process_name,
               bool is_background,
               struct parsed_command* parsed) {
+  if (!k_pid_available()) {
+    P_ERRNO = EPIDS;
+    return -1;
+  }
   spthread_t childThread;
   spthread_create(&childThread, NULL, *func, argv);
   pcb* parent = k_get_proc();
@@ -19,10 +36,7 @@ pid_t s_spawn(void* (*func)(void*),
                              process_name, is_background, parsed);
 
   // Write log
-  char message[100];
-  sprintf(message, "[%3d]\tCREATE   \t%d\t%d\t%-15s\n", ticks, child->pid,
-          child->priority, process_name);
-  s_log(message);
+  k_trace_event(TRACE_CREATE, child);
 
   return child->pid;
 }
@@ -43,26 +57,84 @@ int s_kill(pid_t pid, int signal) {
   return res;
 }
 
+int s_setpgid(pid_t pid, pid_t pgid) {
+  if (pid == 0) {
+    pid = currentJob;
+  }
+  int res = k_setpgid(pid, pgid);
+  if (res == -1) {
+    P_ERRNO = EPGRP;
+  }
+  return res;
+}
+
+pid_t s_getpgid(pid_t pid) {
+  if (pid == 0) {
+    pid = currentJob;
+  }
+  pid_t pgid = k_getpgid(pid);
+  if (pgid == -1) {
+    P_ERRNO = EPGRP;
+  }
+  return pgid;
+}
+
+int s_killpg(pid_t pgid, int signal) {
+  int res = k_killpg(pgid, signal);
+  if (res == -1) {
+    P_ERRNO = EPGRP;
+  }
+  return res;
+}
+
 void s_exit(void) {
   k_exit();
 }
 
-int s_handle_fg(pid_t pid) {
-  return k_handle_fg(pid);
+int s_handle_fg(int job_id) {
+  return k_handle_fg(job_id);
 }
 
-int s_handle_bg(pid_t pid) {
-  return k_handle_bg(pid);
+int s_handle_bg(int job_id) {
+  return k_handle_bg(job_id);
+}
+
+int s_aging(int threshold, int max_boost) {
+  int res = k_aging_set(threshold, max_boost);
+  if (res == -1) {
+    P_ERRNO = EARG;
+  }
+  return res;
+}
+
+void s_jobs(int output_fd) {
+  k_jobs_print(output_fd);
 }
 
 int s_nice(pid_t pid, int priority) {
-  if (priority < 0 || priority > 2) {
+  if (priority < 0 || priority >= k_num_levels()) {
     P_ERRNO = EARG;
     return -1;
   }
   return k_change_priority(pid, priority);
 }
 
+int s_sched_setattr(pid_t pid, int period, int budget) {
+  if (pid == 0) {
+    pid = currentJob;
+  }
+  bool leave = period == 0 && budget == 0;
+  if (!leave && (period <= 0 || budget <= 0 || budget > period)) {
+    P_ERRNO = EARG;
+    return -1;
+  }
+  int res = k_sched_setattr(pid, period, budget);
+  if (res == -1) {
+    P_ERRNO = PCBDequeJobSearch(PCBList, pid) == NULL ? EARG : ERTCAP;
+  }
+  return res;
+}
+
 void s_sleep(unsigned int ticks) {
   k_sleep(ticks);
 }
@@ -75,6 +147,277 @@ void s_ps() {
   k_ps();
 }
 
+void s_schedstat() {
+  pcb* curr_job = k_get_proc();
+  k_schedstat(curr_job->process_fdt[1]);
+}
+
+void s_cgstat() {
+  pcb* curr_job = k_get_proc();
+  k_cgroup_print(curr_job->process_fdt[1]);
+}
+
+int s_cgroup_create(const char* name, const char* parent) {
+  int parent_id = parent != NULL ? k_cgroup_lookup(parent) : CGROUP_ROOT;
+  if (parent_id == -1) {
+    P_ERRNO = ECGROUP;
+    return -1;
+  }
+  int id = k_cgroup_create(name, parent_id);
+  if (id == -1) {
+    P_ERRNO = EARG;
+  }
+  return id;
+}
+
+int s_cgroup_destroy(const char* name) {
+  int id = k_cgroup_lookup(name);
+  if (id == -1 || k_cgroup_destroy(id) == -1) {
+    P_ERRNO = ECGROUP;
+    return -1;
+  }
+  return 0;
+}
+
+int s_cgroup_set(const char* name, int shares, int quota, int period) {
+  int id = k_cgroup_lookup(name);
+  if (id == -1) {
+    P_ERRNO = ECGROUP;
+    return -1;
+  }
+  int res = k_cgroup_set(id, shares, quota, period);
+  if (res == -1) {
+    P_ERRNO = EARG;
+  }
+  return res;
+}
+
+int s_cgroup_attach(pid_t pid, const char* name) {
+  if (pid == 0) {
+    pid = currentJob;
+  }
+  int id = k_cgroup_lookup(name);
+  if (id == -1) {
+    P_ERRNO = ECGROUP;
+    return -1;
+  }
+  int res = k_cgroup_attach(pid, id);
+  if (res == -1) {
+    P_ERRNO = EARG;
+  }
+  return res;
+}
+
+void s_syncstat() {
+  pcb* curr_job = k_get_proc();
+  k_sync_print(curr_job->process_fdt[1]);
+}
+
+static int sync_create(const char* name,
+                       sync_kind kind,
+                       int value,
+                       bool by_priority) {
+  int id = k_sync_create(name, kind, value, by_priority);
+  if (id == -1) {
+    P_ERRNO = EARG;
+  }
+  return id;
+}
+
+static int sync_open(const char* name, sync_kind kind) {
+  int id = k_sync_lookup(name, kind);
+  if (id == -1) {
+    P_ERRNO = ESYNC;
+  }
+  return id;
+}
+
+static int sync_destroy(int id, sync_kind kind) {
+  int res = k_sync_destroy(id, kind);
+  if (res == -1) {
+    P_ERRNO = ESYNC;
+  }
+  return res;
+}
+
+static int sync_acquire(int id, sync_kind kind, bool try) {
+  int res = k_sync_acquire(id, kind, try);
+  if (res == -1) {
+    P_ERRNO = ESYNC;
+  }
+  return res;
+}
+
+static int sync_release(int id, sync_kind kind) {
+  int res = k_sync_release(id, kind);
+  if (res == -1) {
+    P_ERRNO = kind == SYNC_MUTEX ? EPERM : ESYNC;
+  }
+  return res;
+}
+
+int s_sem_create(const char* name, int value, bool by_priority) {
+  return sync_create(name, SYNC_SEM, value, by_priority);
+}
+
+int s_sem_open(const char* name) {
+  return sync_open(name, SYNC_SEM);
+}
+
+int s_sem_destroy(int sem) {
+  return sync_destroy(sem, SYNC_SEM);
+}
+
+int s_sem_wait(int sem) {
+  return sync_acquire(sem, SYNC_SEM, false);
+}
+
+int s_sem_trywait(int sem) {
+  return sync_acquire(sem, SYNC_SEM, true);
+}
+
+int s_sem_post(int sem) {
+  return sync_release(sem, SYNC_SEM);
+}
+
+int s_mutex_create(const char* name, bool by_priority) {
+  return sync_create(name, SYNC_MUTEX, 1, by_priority);
+}
+
+int s_mutex_open(const char* name) {
+  return sync_open(name, SYNC_MUTEX);
+}
+
+int s_mutex_destroy(int mutex) {
+  return sync_destroy(mutex, SYNC_MUTEX);
+}
+
+int s_mutex_lock(int mutex) {
+  return sync_acquire(mutex, SYNC_MUTEX, false);
+}
+
+int s_mutex_trylock(int mutex) {
+  return sync_acquire(mutex, SYNC_MUTEX, true);
+}
+
+int s_mutex_unlock(int mutex) {
+  return sync_release(mutex, SYNC_MUTEX);
+}
+
+void s_shmstat() {
+  pcb* curr_job = k_get_proc();
+  k_shm_print(curr_job->process_fdt[1]);
+}
+
+int s_shm_open(const char* name, size_t size, bool create) {
+  int id = k_shm_open(name, size, create);
+  if (id == -1) {
+    P_ERRNO = create ? EARG : ESHM;
+  }
+  return id;
+}
+
+void* s_shm_map(int shm, size_t* size) {
+  void* addr = k_shm_map(shm, size);
+  if (addr == NULL) {
+    P_ERRNO = ESHM;
+  }
+  return addr;
+}
+
+int s_shm_unmap(void* addr) {
+  int res = k_shm_unmap(addr);
+  if (res == -1) {
+    P_ERRNO = ESHM;
+  }
+  return res;
+}
+
+int s_shm_unlink(const char* name) {
+  int res = k_shm_unlink(name);
+  if (res == -1) {
+    P_ERRNO = ESHM;
+  }
+  return res;
+}
+
+void s_mqstat() {
+  pcb* curr_job = k_get_proc();
+  k_mq_print(curr_job->process_fdt[1]);
+}
+
+int s_mq_open(const char* name, int capacity, bool create) {
+  int id = k_mq_open(name, capacity == 0 ? MQ_DEFAULT_CAPACITY : capacity,
+                     create);
+  if (id == -1) {
+    P_ERRNO = create ? EARG : EMQ;
+  }
+  return id;
+}
+
+int s_mq_destroy(int mq) {
+  int res = k_mq_destroy(mq);
+  if (res == -1) {
+    P_ERRNO = EMQ;
+  }
+  return res;
+}
+
+int s_mq_send_batch(int mq, const mq_msg* msgs, int n, bool nohang) {
+  if (n < 0 || (n > 0 && msgs == NULL)) {
+    P_ERRNO = EARG;
+    return -1;
+  }
+  for (int i = 0; i < n; i++) {
+    if (msgs[i].len < 0 || msgs[i].len > MQ_MSG_MAX ||
+        (msgs[i].data == NULL && msgs[i].len > 0)) {
+      P_ERRNO = EARG;
+      return -1;
+    }
+  }
+  int res = k_mq_send(mq, msgs, n, nohang);
+  if (res == -1) {
+    P_ERRNO = EMQ;
+  }
+  return res;
+}
+
+int s_mq_recv_batch(int mq, mq_msg* msgs, int n, bool nohang) {
+  if (n < 0 || (n > 0 && msgs == NULL)) {
+    P_ERRNO = EARG;
+    return -1;
+  }
+  for (int i = 0; i < n; i++) {
+    if (msgs[i].len < 0 || (msgs[i].data == NULL && msgs[i].len > 0)) {
+      P_ERRNO = EARG;
+      return -1;
+    }
+  }
+  int res = k_mq_recv(mq, msgs, n, nohang);
+  if (res == -1) {
+    P_ERRNO = EMQ;
+  }
+  return res;
+}
+
+int s_mq_send(int mq, const void* buf, int len) {
+  mq_msg msg = {.data = (void*)buf, .len = len};
+  return s_mq_send_batch(mq, &msg, 1, false) == -1 ? -1 : 0;
+}
+
+int s_mq_recv(int mq, void* buf, int len) {
+  mq_msg msg = {.data = buf, .len = len};
+  return s_mq_recv_batch(mq, &msg, 1, false) == -1 ? -1 : msg.len;
+}
+
+int s_poll(p_pollfd* fds, int nfds, int timeout) {
+  if (nfds < 0 || (nfds > 0 && fds == NULL) || (nfds == 0 && timeout < 0)) {
+    P_ERRNO = EARG;
+    return -1;
+  }
+  return k_poll(fds, nfds, timeout);
+}
+
 /********************************/
 /*     FAT S Functions          */
 /********************************/
@@ -100,6 +443,11 @@ int s_open(const char* fname, int mode) {
 
   // Add to process-level FDT
   pcb* curr_job = k_get_proc();
+  if (!PCB_FDT_Reserve(curr_job, fd)) {
+    k_close(fd);
+    P_ERRNO = EFD;
+    return -1;
+  }
   curr_job->process_fdt[fd] = fd;
 
   return fd;
@@ -116,7 +464,9 @@ int s_write(int fd, const char* str, int n) {
 int s_close(int fd) {
   // Close on process-level FDT
   pcb* curr_job = k_get_proc();
-  curr_job->process_fdt[fd] = -1;
+  if (fd >= 0 && fd < curr_job->fdt_size) {
+    curr_job->process_fdt[fd] = -1;
+  }
 
   return k_close(fd);
 }
@@ -129,6 +479,175 @@ int s_lseek(int fd, int offset, int whence) {
   return k_lseek(fd, offset, whence);
 }
 
+// Number of entries from ops[start] on that can share one call: a run of
+// touches, or of writes to the same descriptor
+static int run_length(p_subentry* ops, int n, int start) {
+  int op = ops[start].op;
+  int end = start + 1;
+  if (op == P_SUB_TOUCH || op == P_SUB_WRITE) {
+    while (end < n && ops[end].op == op &&
+           (op == P_SUB_TOUCH || ops[end].fd == ops[start].fd)) {
+      end++;
+    }
+  }
+  return end - start;
+}
+
+static void submit_touches(p_subentry* ops, int n) {
+  char** names = malloc(n * sizeof(char*));
+  int* results = malloc(n * sizeof(int));
+  if (names == NULL || results == NULL) {
+    free(names);
+    free(results);
+    for (int i = 0; i < n; i++) {
+      ops[i].res = -1;
+      ops[i].err = EHOST;
+    }
+    return;
+  }
+  for (int i = 0; i < n; i++) {
+    names[i] = ops[i].fname;
+  }
+  k_touch_many(names, n, results);
+  for (int i = 0; i < n; i++) {
+    ops[i].res = results[i];
+    ops[i].err = results[i] == -1 ? P_ERRNO : 0;
+  }
+  free(names);
+  free(results);
+}
+
+// A write s_write would accept: a length of 0 or more, and a buffer unless
+// the length is 0
+static bool valid_write(const p_subentry* op) {
+  return op->n >= 0 && (op->buf != NULL || op->n == 0);
+}
+
+// Entries with a negative length or no buffer fail with EARG on their own,
+// as s_write would fail them, and are left out of the joined write
+static void submit_writes(p_subentry* ops, int n) {
+  long total = 0;
+  for (int i = 0; i < n; i++) {
+    if (valid_write(&ops[i])) {
+      total += ops[i].n;
+    } else {
+      ops[i].res = -1;
+      ops[i].err = EARG;
+    }
+  }
+  if (total > INT_MAX) {
+    // too much to join; write the entries one by one instead
+    for (int i = 0; i < n; i++) {
+      if (valid_write(&ops[i])) {
+        ops[i].res = s_write(ops[i].fd, ops[i].buf, ops[i].n);
+        ops[i].err = ops[i].res == -1 ? P_ERRNO : 0;
+      }
+    }
+    return;
+  }
+  char* joined = malloc(total > 0 ? total : 1);
+  if (joined == NULL) {
+    for (int i = 0; i < n; i++) {
+      if (valid_write(&ops[i])) {
+        ops[i].res = -1;
+        ops[i].err = EHOST;
+      }
+    }
+    return;
+  }
+  int offset = 0;
+  for (int i = 0; i < n; i++) {
+    if (valid_write(&ops[i]) && ops[i].n > 0) {
+      memcpy(joined + offset, ops[i].buf, ops[i].n);
+      offset += ops[i].n;
+    }
+  }
+  int written = s_write(ops[0].fd, joined, total);
+  free(joined);
+
+  // Hand the bytes written out in order, as separate writes would have
+  for (int i = 0; i < n; i++) {
+    if (!valid_write(&ops[i])) {
+      continue;
+    }
+    if (written == -1) {
+      ops[i].res = -1;
+    } else {
+      ops[i].res = written < ops[i].n ? written : ops[i].n;
+      written -= ops[i].res;
+    }
+    ops[i].err = ops[i].res == -1 ? P_ERRNO : 0;
+  }
+}
+
+static void submit_one(p_subentry* op) {
+  switch (op->op) {
+    case P_SUB_OPEN:
+      op->res = s_open(op->fname, op->mode);
+      break;
+    case P_SUB_READ:
+      op->res = s_read(op->fd, op->n, op->buf);
+      break;
+    case P_SUB_LSEEK:
+      op->res = s_lseek(op->fd, op->n, op->mode);
+      break;
+    case P_SUB_CLOSE:
+      op->res = s_close(op->fd);
+      break;
+    case P_SUB_UNLINK:
+      op->res = s_unlink(op->fname);
+      break;
+    default:
+      P_ERRNO = EARG;
+      op->res = -1;
+      break;
+  }
+  op->err = op->res == -1 ? P_ERRNO : 0;
+}
+
+int s_submit(p_subentry* ops, int n) {
+  if (n < 0 || (n > 0 && ops == NULL)) {
+    P_ERRNO = EARG;
+    return -1;
+  }
+  int failed = 0;
+  for (int i = 0; i < n;) {
+    int run = run_length(ops, n, i);
+    if (ops[i].op == P_SUB_TOUCH) {
+      submit_touches(&ops[i], run);
+    } else if (ops[i].op == P_SUB_WRITE) {
+      submit_writes(&ops[i], run);
+    } else {
+      submit_one(&ops[i]);
+    }
+    for (int j = i; j < i + run; j++) {
+      failed += ops[j].res == -1;
+    }
+    i += run;
+  }
+  return n - failed;
+}
+
+int s_aread(int fd, int n, char* buf) {
+  return k_aio_submit(fd, buf, n, false);
+}
+
+int s_awrite(int fd, const char* str, int n) {
+  return k_aio_submit(fd, (char*)str, n, true);
+}
+
+int s_await(int ticket) {
+  if (k_aio_poll(ticket) == P_POLLNVAL) {
+    P_ERRNO = EAIO;
+    return -1;
+  }
+  int res = k_aio_await(ticket);
+  if (res == -1) {
+    P_ERRNO = EHOST;
+  }
+  return res;
+}
+
 int s_ls(const char* filename, int output_fd) {
   return k_ls(filename, output_fd);
 }
@@ -8,7 +8,10 @@
 #include "../fat/fat_helper.h"
 #include "../util/globals.h"
 #include "../util/os_errors.h"
+#include "./fdpoll.h"
 #include "./kernel.h"
+#include "./mq.h"
+#include "./submit.h"
 
 /**
  * @brief Create a child process that executes the function `func`.
@@ -20,7 +23,8 @@
  * @param fd0 Input file descriptor.
  * @param fd1 Output file descriptor.
  * @param process_name Name of the process.
- * @return pid_t The process ID of the created child process.
+ * @return pid_t The process ID of the created child process, or -1 on error
+ * (EPIDS if every PID up to the maximum is in use).
  */
 pid_t s_spawn(void* (*func)(void*),
               char* argv[],
@@ -53,6 +57,32 @@ pid_t s_waitpid(pid_t pid, int* wstatus, bool nohang);
  */
 int s_kill(pid_t pid, int signal);
 
+/**
+ * @brief Move a process into a process group.
+ *
+ * @param pid Process to move, 0 for the calling process.
+ * @param pgid Group to join, or 0 (or pid) to start a new group led by pid.
+ * @return 0 on success, -1 on error.
+ */
+int s_setpgid(pid_t pid, pid_t pgid);
+
+/**
+ * @brief Get the process group of a process.
+ *
+ * @param pid Process to look up, 0 for the calling process.
+ * @return The process group id, -1 on error.
+ */
+pid_t s_getpgid(pid_t pid);
+
+/**
+ * @brief Send a signal to every process in a process group.
+ *
+ * @param pgid Process group to signal.
+ * @param signal Signal number to be sent.
+ * @return 0 if any process was signalled, -1 on error.
+ */
+int s_killpg(pid_t pgid, int signal);
+
 /**
  * @brief Unconditionally exit the calling process.
  */
@@ -62,7 +92,8 @@ void s_exit(void);
  * @brief Set the priority of the specified thread.
  *
  * @param pid Process ID of the target thread.
- * @param priority The new priorty value of the thread (0, 1, or 2)
+ * @param priority The new priorty value of the thread, from 0 to one less
+ * than the number of levels (0, 1, or 2 by default)
  * @return 0 on success, -1 on failure.
  */
 int s_nice(pid_t pid, int priority);
@@ -94,6 +125,38 @@ void s_log(char* message);
  */
 void s_ps();
 
+/**
+ * @brief Prints the scheduling latency histograms for each priority level.
+ *
+ */
+void s_schedstat();
+
+/**
+ * @brief Prints the shares, quota and usage of every CPU group.
+ *
+ */
+void s_cgstat();
+
+/**
+ * @brief Prints the count or owner, waiters and contention of every
+ * semaphore and mutex.
+ *
+ */
+void s_syncstat();
+
+/**
+ * @brief Prints the size and number of mappings of every shared-memory
+ * segment.
+ *
+ */
+void s_shmstat();
+
+/**
+ * @brief Prints the capacity, backlog and traffic of every message queue.
+ *
+ */
+void s_mqstat();
+
 /**
  * @brief Creates the files if they do not exist, or updates their timestamp to
  * the current system time
@@ -198,20 +261,340 @@ int s_ls(const char* filename, int output_fd);
 int s_findperm(char* filename);
 
 /**
- * @brief Handles the bg command on specfied pid
+ * @brief Handles the bg command on specfied job
  *
- * @param pid job to resume in the background, -1 if no job provided to bg
+ * @param job_id job to resume in the background, -1 if no job provided to bg
  * command
  * @return 0 on successs, -1 on error
  */
-int s_handle_bg(pid_t pid);
+int s_handle_bg(int job_id);
 
 /**
- * @brief Handles thefbg command on specfied pid
+ * @brief Handles the fg command on specfied job
  *
- * @param pid job to resume in the foreground, -1 if no job provided to fg
+ * @param job_id job to resume in the foreground, -1 if no job provided to fg
  * command
  * @return 0 on successs, -1 on error
  */
-int s_handle_fg(pid_t pid);
+int s_handle_fg(int job_id);
+
+/**
+ * @brief Puts a process in the real-time class, which runs it for budget
+ * ticks in every period of period ticks ahead of all best-effort jobs, or
+ * with both 0 returns it to its priority level.
+ *
+ * @param pid the process, 0 for the calling process
+ * @param period ticks per period, which is also the relative deadline
+ * @param budget ticks to run per period, at most period
+ * @return 0 on success, -1 on error (ERTCAP if admitting the process would
+ * reserve more than EDF_MAX_UTIL of the CPU)
+ */
+int s_sched_setattr(pid_t pid, int period, int budget);
+
+/**
+ * @brief Configures anti-starvation aging.
+ *
+ * @param threshold ticks a runnable job may wait before it is boosted one
+ * level, 0 to turn aging off
+ * @param max_boost maximum number of levels a job can be boosted by, at least
+ * 1 and below MAX_PRIORITY_LEVELS
+ * @return 0 on success, -1 on error
+ */
+int s_aging(int threshold, int max_boost);
+
+/**
+ * @brief Lists the jobs in the job table.
+ *
+ * @param output_fd file descriptor to write the list to
+ */
+void s_jobs(int output_fd);
+
+/**
+ * @brief Creates a CPU group (see cgroup.h) with the default shares and no
+ * quota.
+ *
+ * @param name a unique name of at most CGROUP_NAME_MAX - 1 characters
+ * @param parent name of the parent group, NULL for the root
+ * @return the group's id on success, -1 on error (ECGROUP if the parent does
+ * not exist)
+ */
+int s_cgroup_create(const char* name, const char* parent);
+
+/**
+ * @brief Destroys a CPU group with no processes and no child groups.
+ *
+ * @return 0 on success, -1 on error
+ */
+int s_cgroup_destroy(const char* name);
+
+/**
+ * @brief Sets a CPU group's shares and its hard quota of ticks per period.
+ *
+ * @param name the group, which may not be the root
+ * @param shares weight against the group's siblings, CGROUP_DEFAULT_SHARES
+ * being an even split
+ * @param quota ticks the group and its descendants may run per period, 0 for
+ * no limit
+ * @param period ticks per accounting period
+ * @return 0 on success, -1 on error
+ */
+int s_cgroup_set(const char* name, int shares, int quota, int period);
+
+/**
+ * @brief Moves a process into a CPU group. Its future children start in the
+ * same group.
+ *
+ * @param pid the process, 0 for the calling process
+ * @param name the group
+ * @return 0 on success, -1 on error
+ */
+int s_cgroup_attach(pid_t pid, const char* name);
+
+/**
+ * @brief Creates a counting semaphore (see sync.h).
+ *
+ * @param name a name of at most SYNC_NAME_MAX - 1 characters, unique among
+ * semaphores
+ * @param value the initial count, at most SYNC_VALUE_MAX
+ * @param by_priority wake the waiter at the best priority level first rather
+ * than the one that has waited longest
+ * @return the semaphore's id on success, -1 on error
+ */
+int s_sem_create(const char* name, int value, bool by_priority);
+
+/**
+ * @brief Looks up a semaphore by name.
+ *
+ * @return the semaphore's id on success, -1 on error (ESYNC if there is no
+ * such semaphore)
+ */
+int s_sem_open(const char* name);
+
+/**
+ * @brief Destroys a semaphore no process waits on.
+ *
+ * @return 0 on success, -1 on error
+ */
+int s_sem_destroy(int sem);
+
+/**
+ * @brief Takes a unit of a semaphore. If there is none, the calling process
+ * blocks, without running, until a post hands one to it.
+ *
+ * @return 0 on success, -1 on error
+ */
+int s_sem_wait(int sem);
+
+/**
+ * @brief Takes a unit of a semaphore if there is one, without blocking.
+ *
+ * @return 0 if a unit was taken, 1 if there was none, -1 on error
+ */
+int s_sem_trywait(int sem);
+
+/**
+ * @brief Returns a unit to a semaphore, waking the next waiter if there is
+ * one.
+ *
+ * @return 0 on success, -1 on error (ESYNC also if the count is at
+ * SYNC_VALUE_MAX)
+ */
+int s_sem_post(int sem);
+
+/**
+ * @brief Creates an unlocked mutex (see sync.h).
+ *
+ * @param name a name of at most SYNC_NAME_MAX - 1 characters, unique among
+ * mutexes
+ * @param by_priority wake the waiter at the best priority level first rather
+ * than the one that has waited longest
+ * @return the mutex's id on success, -1 on error
+ */
+int s_mutex_create(const char* name, bool by_priority);
+
+/**
+ * @brief Looks up a mutex by name.
+ *
+ * @return the mutex's id on success, -1 on error (ESYNC if there is no such
+ * mutex)
+ */
+int s_mutex_open(const char* name);
+
+/**
+ * @brief Destroys a mutex that is unlocked and no process waits on.
+ *
+ * @return 0 on success, -1 on error
+ */
+int s_mutex_destroy(int mutex);
+
+/**
+ * @brief Locks a mutex for the calling process, blocking it until the mutex
+ * is handed over if another process holds it. The holder unlocks it, or it
+ * is unlocked when the holder exits or is killed.
+ *
+ * @return 0 on success, -1 on error (ESYNC also if the caller holds it)
+ */
+int s_mutex_lock(int mutex);
+
+/**
+ * @brief Locks a mutex if it is unlocked, without blocking.
+ *
+ * @return 0 if it was locked, 1 if another process holds it, -1 on error
+ */
+int s_mutex_trylock(int mutex);
+
+/**
+ * @brief Unlocks a mutex the calling process holds, handing it to the next
+ * waiter if there is one.
+ *
+ * @return 0 on success, -1 on error (EPERM if the caller does not hold it)
+ */
+int s_mutex_unlock(int mutex);
+
+/**
+ * @brief Opens a shared-memory segment (see shm.h) by name, creating it if
+ * there is none and create is set. A new segment is zero-filled.
+ *
+ * @param name a name of at most SHM_NAME_MAX - 1 characters
+ * @param size bytes the segment must have at least, at most SHM_SIZE_MAX; 0
+ * to open a segment of any size
+ * @return the segment's id on success, -1 on error (ESHM if there is no such
+ * segment, or EARG if it is smaller than size or cannot be created)
+ */
+int s_shm_open(const char* name, size_t size, bool create);
+
+/**
+ * @brief Maps a shared-memory segment into the calling process. Every
+ * process that maps it gets the same address, and mapping it twice counts
+ * once.
+ *
+ * @param shm the segment's id
+ * @param size set to the segment's size if not NULL
+ * @return the segment's address on success, NULL on error
+ */
+void* s_shm_map(int shm, size_t* size);
+
+/**
+ * @brief Unmaps a shared-memory segment from the calling process. Segments
+ * still mapped when a process is cleaned up are unmapped then.
+ *
+ * @param addr the address s_shm_map returned
+ * @return 0 on success, -1 on error
+ */
+int s_shm_unmap(void* addr);
+
+/**
+ * @brief Deletes a shared-memory segment. It can no longer be opened, and
+ * its memory is freed once no process has it mapped.
+ *
+ * @return 0 on success, -1 on error
+ */
+int s_shm_unlink(const char* name);
+
+/**
+ * @brief Opens a message queue (see mq.h) by name, creating it if there is
+ * none and create is set.
+ *
+ * @param name a name of at most MQ_NAME_MAX - 1 characters
+ * @param capacity messages a new queue holds, 0 for MQ_DEFAULT_CAPACITY
+ * @return the queue's id on success, -1 on error (EMQ if there is no such
+ * queue)
+ */
+int s_mq_open(const char* name, int capacity, bool create);
+
+/**
+ * @brief Destroys a message queue no process waits on, dropping its
+ * messages.
+ *
+ * @return 0 on success, -1 on error
+ */
+int s_mq_destroy(int mq);
+
+/**
+ * @brief Sends a message of at most MQ_MSG_MAX bytes, blocking the calling
+ * process while the queue is full.
+ *
+ * @return 0 on success, -1 on error
+ */
+int s_mq_send(int mq, const void* buf, int len);
+
+/**
+ * @brief Receives the oldest message into buf, blocking the calling process
+ * while the queue is empty. A message longer than len is cut short.
+ *
+ * @return the number of bytes received on success, -1 on error
+ */
+int s_mq_recv(int mq, void* buf, int len);
+
+/**
+ * @brief Sends up to n messages in one call, as many as the queue has room
+ * for. Blocks while it is full unless nohang is set.
+ *
+ * @return the number of messages sent (0 only if nohang is set or n is 0), -1
+ * on error
+ */
+int s_mq_send_batch(int mq, const mq_msg* msgs, int n, bool nohang);
+
+/**
+ * @brief Receives up to n messages in one call, as many as are queued. Blocks
+ * while the queue is empty unless nohang is set. Sets each buffer's len to
+ * the bytes received into it.
+ *
+ * @return the number of messages received (0 only if nohang is set or n is
+ * 0), -1 on error
+ */
+int s_mq_recv_batch(int mq, mq_msg* msgs, int n, bool nohang);
+
+/**
+ * @brief Waits until one of a set of file descriptors, message queues and
+ * I/O tickets (see fdpoll.h) is ready. The calling process blocks in the
+ * inactive queue, not running, until a queue in the set gets a message or
+ * room, stdin gets input, an I/O operation finishes, or the timeout runs out.
+ *
+ * @param fds the set; each entry's revents is set to the events in it that
+ * are ready, or to P_POLLNVAL for a closed descriptor, missing queue or
+ * ticket that is not the caller's
+ * @param nfds number of entries
+ * @param timeout ticks to wait at most, 0 to return at once, -1 for no limit
+ * @return the number of entries that are ready, 0 on timeout, -1 on error
+ */
+int s_poll(p_pollfd* fds, int nfds, int timeout);
+
+/**
+ * @brief Carries out n file system calls handed over as one batch (see
+ * submit.h), setting each entry's res and err. Runs of touches and of writes
+ * to one descriptor are done as a single call.
+ *
+ * @return the number of entries that succeeded, -1 if the arguments are
+ * invalid
+ */
+int s_submit(p_subentry* ops, int n);
+
+/**
+ * @brief Starts reading up to n bytes from a file into buf without waiting
+ * for them (see aio.h). The offset moves past the bytes at once, so the next
+ * s_aread continues after them. buf must stay valid until s_await returns.
+ *
+ * @return a ticket to pass to s_await or to s_poll with P_POLLAIO, -1 on
+ * error (EAIO if too many operations are in flight)
+ */
+int s_aread(int fd, int n, char* buf);
+
+/**
+ * @brief Starts writing n bytes from str to a file without waiting for them,
+ * growing the file as needed. str must stay valid until s_await returns.
+ *
+ * @return a ticket to pass to s_await or to s_poll with P_POLLAIO, -1 on
+ * error (EAIO if too many operations are in flight)
+ */
+int s_awrite(int fd, const char* str, int n);
+
+/**
+ * @brief Blocks until the operation behind a ticket of the calling process
+ * is done, and frees the ticket.
+ *
+ * @return the number of bytes read (0 at the end of the file) or written, -1
+ * on error
+ */
+int s_await(int ticket);
 #endif
\ No newline at end of file
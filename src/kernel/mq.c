@@ -0,0 +1,312 @@
+#include "mq.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "../util/PIDDeque.h"
+#include "fdpoll.h"
+#include "kernel.h"
+
+// Position i of a queue is in slot i & (capacity - 1). The slot's sequence
+// number says who owns it: seqs[slot] == i means free for the sender claiming
+// i, seqs[slot] == i + 1 means the message for i is published and ready for
+// the receiver claiming it.
+typedef struct message_queue {
+  bool in_use;
+  char name[MQ_NAME_MAX];
+  uint32_t capacity;          // a power of two
+  _Atomic uint64_t head;      // next position to claim (receivers)
+  _Atomic uint64_t tail;      // next position to claim (senders)
+  _Atomic uint64_t* seqs;     // per slot, as above
+  char (*slots)[MQ_MSG_MAX];  // message contents
+  int* lengths;               // and lengths
+  PIDDeque* receivers;        // blocked on an empty queue
+  PIDDeque* senders;          // blocked on a full queue
+  _Atomic long sent;
+  _Atomic long received;
+  _Atomic long waits;  // # times a process had to block
+} message_queue;
+
+static message_queue queues[MQ_MAX];
+
+void k_mq_init() {
+  memset(queues, 0, sizeof(queues));
+}
+
+static void queue_free(message_queue* q) {
+  free(q->seqs);
+  free(q->slots);
+  free(q->lengths);
+  PIDDeque_Free(q->receivers);
+  PIDDeque_Free(q->senders);
+  *q = (message_queue){0};
+}
+
+void k_mq_free() {
+  for (int id = 0; id < MQ_MAX; id++) {
+    if (queues[id].in_use) {
+      queue_free(&queues[id]);
+    }
+  }
+}
+
+static message_queue* get(int id) {
+  if (id < 0 || id >= MQ_MAX || !queues[id].in_use) {
+    return NULL;
+  }
+  return &queues[id];
+}
+
+static int lookup(const char* name) {
+  for (int id = 0; id < MQ_MAX; id++) {
+    if (queues[id].in_use && strcmp(queues[id].name, name) == 0) {
+      return id;
+    }
+  }
+  return -1;
+}
+
+int k_mq_open(const char* name, int capacity, bool create) {
+  size_t len = strlen(name);
+  if (len == 0 || len >= MQ_NAME_MAX || capacity <= 0 ||
+      capacity > MQ_CAPACITY_MAX) {
+    return -1;
+  }
+  int id = lookup(name);
+  if (id != -1 || !create) {
+    return id;
+  }
+  uint32_t rounded = 1;
+  while (rounded < (uint32_t)capacity) {
+    rounded *= 2;
+  }
+  for (id = 0; id < MQ_MAX; id++) {
+    message_queue* q = &queues[id];
+    if (!q->in_use) {
+      *q = (message_queue){
+          .in_use = true,
+          .capacity = rounded,
+          .seqs = malloc(rounded * sizeof(_Atomic uint64_t)),
+          .slots = malloc(rounded * MQ_MSG_MAX),
+          .lengths = malloc(rounded * sizeof(int)),
+          .receivers = PIDDeque_Allocate(),
+          .senders = PIDDeque_Allocate(),
+      };
+      for (uint32_t i = 0; i < rounded; i++) {
+        atomic_init(&q->seqs[i], i);
+      }
+      snprintf(q->name, sizeof(q->name), "%s", name);
+      return id;
+    }
+  }
+  return -1;
+}
+
+int k_mq_destroy(int id) {
+  message_queue* q = get(id);
+  if (q == NULL || PIDDeque_Size(q->receivers) > 0 ||
+      PIDDeque_Size(q->senders) > 0) {
+    return -1;
+  }
+  queue_free(q);
+  k_poll_notify_mq(id);
+  return 0;
+}
+
+short k_mq_poll(int id) {
+  message_queue* q = get(id);
+  if (q == NULL) {
+    return P_POLLNVAL;
+  }
+  uint32_t mask = q->capacity - 1;
+  uint64_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  uint64_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  short ready = 0;
+  if (atomic_load_explicit(&q->seqs[head & mask], memory_order_acquire) ==
+      head + 1) {
+    ready |= P_POLLIN;
+  }
+  if (atomic_load_explicit(&q->seqs[tail & mask], memory_order_acquire) ==
+      tail) {
+    ready |= P_POLLOUT;
+  }
+  return ready;
+}
+
+// Blocks the calling process until a waker takes it off waiters, unless the
+// queue became ready for events (P_POLLIN or P_POLLOUT) before it got on the
+// list: the other side may have finished and woken nobody in between.
+// Returns the queue again, or NULL if it was destroyed in the meantime.
+static message_queue* wait_on(int id, PIDDeque* waiters, short events) {
+  pcb* proc = k_get_proc();
+  if (!PIDDequeJobSearch(waiters, proc->pid)) {
+    PIDDeque_Push_Back(waiters, proc->pid);
+  }
+  if (k_mq_poll(id) & events) {
+    PIDSearchAndDelete(waiters, proc->pid);
+    return get(id);
+  }
+  atomic_fetch_add_explicit(&queues[id].waits, 1, memory_order_relaxed);
+  k_block(proc);
+  spthread_suspend(proc->curr_thread);
+  return get(id);
+}
+
+// Wakes up to n of the processes on waiters, oldest first; each checks the
+// queue again once it runs
+static void wake(PIDDeque* waiters, int n) {
+  pid_t pid;
+  while (n-- > 0 && PIDDeque_Pop_Front(waiters, &pid)) {
+    pcb* proc = PCBDequeJobSearch(PCBList, pid);
+    if (proc != NULL) {
+      k_unblock(proc);
+    }
+  }
+}
+
+// Claims up to n consecutive positions at *end (the queue's tail for a
+// sender, its head for a receiver) whose slots have sequence number
+// position + offset: 0 for free slots, 1 for published messages. Claiming is
+// a compare-and-swap on *end, so two processes never get the same position
+// even if the scheduler suspends one of them half-way through. Returns how
+// many were claimed, with the first in *first; 0 if the next slot is still
+// held by the other side.
+static int claim(message_queue* q,
+                 _Atomic uint64_t* end,
+                 uint64_t offset,
+                 int n,
+                 uint64_t* first) {
+  uint32_t mask = q->capacity - 1;
+  uint64_t pos = atomic_load_explicit(end, memory_order_relaxed);
+  while (true) {
+    int count = 0;
+    while (count < n &&
+           atomic_load_explicit(&q->seqs[(pos + count) & mask],
+                                memory_order_acquire) == pos + count + offset) {
+      count++;
+    }
+    if (count > 0) {
+      if (atomic_compare_exchange_weak_explicit(end, &pos, pos + count,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        *first = pos;
+        return count;
+      }
+      continue;  // pos now holds where the others have got to
+    }
+    uint64_t seq =
+        atomic_load_explicit(&q->seqs[pos & mask], memory_order_acquire);
+    if ((int64_t)(seq - (pos + offset)) < 0) {
+      return 0;
+    }
+    pos = atomic_load_explicit(end, memory_order_relaxed);
+  }
+}
+
+int k_mq_send(int id, const mq_msg* msgs, int n, bool nohang) {
+  message_queue* q = get(id);
+  if (q == NULL || n < 0 || (n > 0 && msgs == NULL)) {
+    return -1;
+  }
+  for (int i = 0; i < n; i++) {
+    if (msgs[i].len < 0 || msgs[i].len > MQ_MSG_MAX ||
+        (msgs[i].data == NULL && msgs[i].len > 0)) {
+      return -1;
+    }
+  }
+  if (n == 0) {
+    return 0;
+  }
+  uint64_t first;
+  int count;
+  while ((count = claim(q, &q->tail, 0, n, &first)) == 0) {
+    if (nohang) {
+      return 0;
+    }
+    q = wait_on(id, q->senders, P_POLLOUT);
+    if (q == NULL) {
+      return -1;
+    }
+  }
+  uint32_t mask = q->capacity - 1;
+  for (int i = 0; i < count; i++) {
+    uint32_t slot = (first + i) & mask;
+    memcpy(q->slots[slot], msgs[i].data, msgs[i].len);
+    q->lengths[slot] = msgs[i].len;
+    atomic_store_explicit(&q->seqs[slot], first + i + 1, memory_order_release);
+  }
+  atomic_fetch_add_explicit(&q->sent, count, memory_order_relaxed);
+  wake(q->receivers, count);
+  if (count > 0) {
+    k_poll_notify_mq(id);
+  }
+  return count;
+}
+
+int k_mq_recv(int id, mq_msg* msgs, int n, bool nohang) {
+  message_queue* q = get(id);
+  if (q == NULL || n < 0 || (n > 0 && msgs == NULL)) {
+    return -1;
+  }
+  for (int i = 0; i < n; i++) {
+    if (msgs[i].len < 0 || (msgs[i].data == NULL && msgs[i].len > 0)) {
+      return -1;
+    }
+  }
+  if (n == 0) {
+    return 0;
+  }
+  uint64_t first;
+  int count;
+  while ((count = claim(q, &q->head, 1, n, &first)) == 0) {
+    if (nohang) {
+      return 0;
+    }
+    q = wait_on(id, q->receivers, P_POLLIN);
+    if (q == NULL) {
+      return -1;
+    }
+  }
+  uint32_t mask = q->capacity - 1;
+  for (int i = 0; i < count; i++) {
+    uint32_t slot = (first + i) & mask;
+    int len = q->lengths[slot] < msgs[i].len ? q->lengths[slot] : msgs[i].len;
+    memcpy(msgs[i].data, q->slots[slot], len);
+    msgs[i].len = len;
+    atomic_store_explicit(&q->seqs[slot], first + i + q->capacity,
+                          memory_order_release);
+  }
+  atomic_fetch_add_explicit(&q->received, count, memory_order_relaxed);
+  wake(q->senders, count);
+  if (count > 0) {
+    k_poll_notify_mq(id);
+  }
+  return count;
+}
+
+void k_mq_forget(pcb* proc) {
+  for (int id = 0; id < MQ_MAX; id++) {
+    if (queues[id].in_use) {
+      PIDSearchAndDelete(queues[id].receivers, proc->pid);
+      PIDSearchAndDelete(queues[id].senders, proc->pid);
+    }
+  }
+}
+
+void k_mq_print(int fd) {
+  char* header = "ID\tCAP\tQUEUED\tSENT\tRECV\tWAITS\tNAME\n";
+  k_write(fd, header, strlen(header));
+  for (int id = 0; id < MQ_MAX; id++) {
+    message_queue* q = &queues[id];
+    if (!q->in_use) {
+      continue;
+    }
+    char row[128];
+    uint64_t queued = atomic_load_explicit(&q->tail, memory_order_relaxed) -
+                      atomic_load_explicit(&q->head, memory_order_relaxed);
+    snprintf(row, sizeof(row), "%d\t%u\t%llu\t%ld\t%ld\t%ld\t%s\n", id,
+             q->capacity, (unsigned long long)queued, q->sent, q->received,
+             q->waits, q->name);
+    k_write(fd, row, strlen(row));
+  }
+}
@@ -0,0 +1,107 @@
+#ifndef MQ_H
+#define MQ_H
+
+#include <stdbool.h>
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Message queues. A queue is a bounded ring of fixed-size message slots,
+// found by name, so a request or reply costs a copy into and out of memory
+// rather than a PennFAT file. Sends and receives move up to n messages per
+// call to spread the call's cost over the batch.
+//
+// A receiver that finds its queue empty, or a sender that finds it full,
+// blocks like a process in waitpid until a send or receive makes room or a
+// message arrives, then wakes in the order it started waiting. Processes
+// polling the queue with s_poll are woken at the same time.
+//
+// The scheduler can suspend a process anywhere in a send or receive, so the
+// ring is a lock-free multi-producer, multi-consumer one like the trace ring.
+// Each slot has a sequence number saying whether it is free or holds a
+// published message. A sender claims a run of free slots by moving the tail
+// on with a compare-and-swap, copies its messages in and then publishes each
+// slot; a receiver claims published slots at the head the same way and frees
+// them once copied out. A process suspended between claiming and publishing
+// holds up only the slots it claimed: the other side sees them as not ready
+// yet and waits, and is woken when they are published.
+///////////////////////////////////////////////////////////////////////////////
+
+#define MQ_MAX 32  // queues that can exist at once
+#define MQ_NAME_MAX 16
+#define MQ_MSG_MAX 256  // bytes per message
+#define MQ_DEFAULT_CAPACITY 64
+#define MQ_CAPACITY_MAX 65536
+
+// A message to send or a buffer to receive one into. For receives, len is
+// the buffer's size going in and the number of bytes received coming out.
+typedef struct mq_msg {
+  void* data;
+  int len;
+} mq_msg;
+
+/**
+ * @brief Empties the queue table. Called from k_allocate_lists.
+ */
+void k_mq_init(void);
+
+/**
+ * @brief Frees every queue and the messages in it.
+ */
+void k_mq_free(void);
+
+/**
+ * @brief Looks a queue up by name, creating it if there is none and create
+ * is set.
+ *
+ * @param capacity messages a new queue holds, rounded up to a power of two
+ * and at most MQ_CAPACITY_MAX; ignored for an existing queue
+ * @return its id, or -1 if there is no such queue and create is not set, an
+ * argument is invalid or MQ_MAX queues exist
+ */
+int k_mq_open(const char* name, int capacity, bool create);
+
+/**
+ * @brief Destroys a queue no process waits on, dropping its messages.
+ *
+ * @return 0 on success, -1 if it does not exist or has waiters
+ */
+int k_mq_destroy(int id);
+
+/**
+ * @brief Returns P_POLLIN if a queue holds a message and P_POLLOUT if it has
+ * room for one (see fdpoll.h), or P_POLLNVAL if it does not exist.
+ */
+short k_mq_poll(int id);
+
+/**
+ * @brief Appends up to n messages to a queue, as many as fit. If none fit,
+ * blocks the calling process until one does unless nohang is set.
+ *
+ * @return the number of messages sent, or -1 if the queue does not exist or
+ * a message is longer than MQ_MSG_MAX or has no buffer
+ */
+int k_mq_send(int id, const mq_msg* msgs, int n, bool nohang);
+
+/**
+ * @brief Removes up to n messages from a queue, as many as it holds. If it
+ * is empty, blocks the calling process until a message arrives unless nohang
+ * is set. A message longer than its buffer is cut short.
+ *
+ * @return the number of messages received, or -1 if the queue does not exist
+ * or a buffer has a negative length or is NULL with a positive one
+ */
+int k_mq_recv(int id, mq_msg* msgs, int n, bool nohang);
+
+/**
+ * @brief Takes a process that is exiting, terminated or cleaned up off every
+ * queue's waiters.
+ */
+void k_mq_forget(pcb* proc);
+
+/**
+ * @brief Writes one line per queue: its capacity, messages queued, messages
+ * sent and received in total and how often a process had to wait.
+ */
+void k_mq_print(int fd);
+
+#endif
@@ -0,0 +1,88 @@
+#include "pidmap.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include "../util/globals.h"
+
+#define WORD_BITS 64
+
+static int pid_max = PID_MAX_DEFAULT;
+static uint64_t* bitmap = NULL;  // bit pid % 64 of word pid / 64 set if used
+static int in_use = 0;
+
+int k_pid_set_max(int max) {
+  if (max < PID_MAX_MIN || max > PID_MAX_LIMIT) {
+    return -1;
+  }
+  pid_max = max;
+  return 0;
+}
+
+int k_pid_max() {
+  return pid_max;
+}
+
+void k_pid_init() {
+  bitmap = calloc((pid_max + WORD_BITS - 1) / WORD_BITS, sizeof(uint64_t));
+  in_use = 0;
+}
+
+void k_pid_free() {
+  free(bitmap);
+  bitmap = NULL;
+}
+
+// Returns the first free PID in [from, to), or -1 if there is none
+static pid_t find_free(pid_t from, pid_t to) {
+  if (from >= to) {
+    return -1;
+  }
+  int word = from / WORD_BITS;
+  // skip the used PIDs and the ones below from in the first word
+  uint64_t free_bits = ~bitmap[word] & (~0ULL << (from % WORD_BITS));
+  int last = (to - 1) / WORD_BITS;
+  while (free_bits == 0) {
+    if (++word > last) {
+      return -1;
+    }
+    free_bits = ~bitmap[word];
+  }
+  pid_t pid = word * WORD_BITS + __builtin_ctzll(free_bits);
+  return pid < to ? pid : -1;
+}
+
+// Returns the PID k_pid_alloc would hand out next, or -1 if none is free
+static pid_t next_free() {
+  pid_t start = pidCount < pid_max ? pidCount : 1;
+  pid_t pid = find_free(start, pid_max);
+  return pid != -1 ? pid : find_free(1, start);
+}
+
+pid_t k_pid_alloc() {
+  pid_t pid = next_free();
+  if (pid == -1) {
+    return -1;
+  }
+  bitmap[pid / WORD_BITS] |= 1ULL << (pid % WORD_BITS);
+  in_use++;
+  pidCount = pid + 1;
+  return pid;
+}
+
+bool k_pid_available() {
+  return next_free() != -1;
+}
+
+void k_pid_release(pid_t pid) {
+  if (pid < 0 || pid >= pid_max) {
+    return;
+  }
+  uint64_t bit = 1ULL << (pid % WORD_BITS);
+  if (bitmap[pid / WORD_BITS] & bit) {
+    bitmap[pid / WORD_BITS] &= ~bit;
+    in_use--;
+  }
+}
+
+int k_pid_in_use() {
+  return in_use;
+}
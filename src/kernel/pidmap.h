@@ -0,0 +1,73 @@
+#ifndef PIDMAP_H
+#define PIDMAP_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// PID allocator. PIDs in use are bits in a bitmap of pid_max bits, so they
+// are reused once freed and stay below pid_max however many processes run
+// over time. That keeps the PID space dense enough for the PID Index to be a
+// plain array indexed by PID.
+//
+// Allocation is next-fit: the search starts after the PID handed out last
+// (pidCount holds the next candidate) and wraps around to 1 at pid_max, so a
+// freed PID is only reused after every other free PID has been handed out
+// once. A stale PID kept by a parent or the shell thus rarely names a new
+// process. PID 0 is never handed out after the first wrap.
+//
+// A PID is free when no process has it and no process group uses it as its
+// pgid, so a new process never joins a group whose leader has exited.
+///////////////////////////////////////////////////////////////////////////////
+
+#define PID_MAX_DEFAULT 32768
+#define PID_MAX_MIN 4
+#define PID_MAX_LIMIT (1 << 22)
+
+/**
+ * @brief Sets the number of PIDs. Must be called before k_allocate_lists.
+ *
+ * @return 0 on success, -1 if max is outside [PID_MAX_MIN, PID_MAX_LIMIT]
+ */
+int k_pid_set_max(int max);
+
+/**
+ * @brief Returns the number of PIDs, one more than the largest PID.
+ */
+int k_pid_max(void);
+
+/**
+ * @brief Allocates the bitmap with every PID free. Called from
+ * k_allocate_lists.
+ */
+void k_pid_init(void);
+
+/**
+ * @brief Frees the bitmap.
+ */
+void k_pid_free(void);
+
+/**
+ * @brief Marks the next free PID at or after pidCount as used, wrapping
+ * around at pid_max, and advances pidCount past it.
+ *
+ * @return the PID, or -1 if all of them are in use
+ */
+pid_t k_pid_alloc(void);
+
+/**
+ * @brief Returns whether a PID could be allocated now.
+ */
+bool k_pid_available(void);
+
+/**
+ * @brief Frees a PID. Freeing a PID that is not in use does nothing.
+ */
+void k_pid_release(pid_t pid);
+
+/**
+ * @brief Returns the number of PIDs in use.
+ */
+int k_pid_in_use(void);
+
+#endif
@@ -0,0 +1,204 @@
+#include "runqueue.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../util/PIDDeque.h"
+#include "../util/macros.h"
+#include "cfs.h"
+#include "cgroup.h"
+#include "edf.h"
+#include "kernel.h"
+
+static int num_levels = 0;
+static int weights[MAX_PRIORITY_LEVELS];
+static int set_weight[1 << MAX_PRIORITY_LEVELS];  // total weight of each set
+                                                  // of levels, by bitmap
+static uint32_t nonempty = 0;  // bit i set while priorityList[i] has a job
+static int policy = SCHED_LOTTERY;
+
+int k_sched_set_policy(const char* name) {
+  if (strcmp(name, "lottery") == 0) {
+    policy = SCHED_LOTTERY;
+  } else if (strcmp(name, "cfs") == 0) {
+    policy = SCHED_CFS;
+  } else {
+    return -1;
+  }
+  return 0;
+}
+
+int k_sched_policy() {
+  return policy;
+}
+
+int k_levels_parse(const char* spec) {
+  int parsed[MAX_PRIORITY_LEVELS];
+  int count = 0;
+  const char* curr = spec;
+  while (true) {
+    char* end;
+    long weight = strtol(curr, &end, 10);
+    if (end == curr || weight <= 0 || weight > 1000000 ||
+        count == MAX_PRIORITY_LEVELS) {
+      return -1;
+    }
+    parsed[count++] = (int)weight;
+    if (*end == '\0') {
+      break;
+    }
+    if (*end != ',') {
+      return -1;
+    }
+    curr = end + 1;
+  }
+
+  num_levels = count;
+  for (int i = 0; i < count; i++) {
+    weights[i] = parsed[i];
+  }
+  for (uint32_t set = 0; set < (1u << count); set++) {
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+      if (set & (1u << i)) {
+        total += weights[i];
+      }
+    }
+    set_weight[set] = total;
+  }
+  nonempty = 0;
+  return 0;
+}
+
+int k_num_levels() {
+  if (num_levels == 0) {
+    k_levels_parse(RUNQUEUE_DEFAULT_WEIGHTS);
+  }
+  return num_levels;
+}
+
+int k_level_weight(int level) {
+  return level >= 0 && level < k_num_levels() ? weights[level] : 0;
+}
+
+void k_runqueue_init() {
+  k_num_levels();
+  nonempty = 0;
+}
+
+static void update_bit(int level) {
+  if (PIDDeque_Size(priorityList[level]) > 0) {
+    nonempty |= 1u << level;
+  } else {
+    nonempty &= ~(1u << level);
+  }
+}
+
+void k_runqueue_push_back(int level, pid_t pid) {
+  PIDDeque_Push_Back(priorityList[level], pid);
+  nonempty |= 1u << level;
+}
+
+void k_runqueue_push_front(int level, pid_t pid) {
+  PIDDeque_Push_Front(priorityList[level], pid);
+  nonempty |= 1u << level;
+}
+
+bool k_runqueue_peek_front(int level, pid_t* pid) {
+  return PIDDeque_Peek_Front(priorityList[level], pid);
+}
+
+bool k_runqueue_pop_front(int level, pid_t* pid) {
+  if (!PIDDeque_Pop_Front(priorityList[level], pid)) {
+    return false;
+  }
+  update_bit(level);
+  return true;
+}
+
+bool k_runqueue_remove(int level, pid_t pid) {
+  bool removed = PIDSearchAndDelete(priorityList[level], pid);
+  update_bit(level);
+  return removed;
+}
+
+void k_runqueue_enqueue(pcb* proc) {
+  if (proc->rt_period > 0) {
+    k_edf_enqueue(proc);
+  } else if (proc->cgroup != CGROUP_ROOT) {
+    k_cgroup_enqueue(proc);
+  } else if (policy == SCHED_CFS) {
+    k_cfs_enqueue(proc);
+  } else {
+    k_runqueue_push_back(k_run_level(proc), proc->pid);
+  }
+}
+
+void k_runqueue_dequeue(pcb* proc) {
+  if (proc->rt_period > 0) {
+    k_edf_remove(proc);
+  } else if (proc->cgroup != CGROUP_ROOT) {
+    k_cgroup_remove(proc);
+  } else if (policy == SCHED_CFS) {
+    k_cfs_remove(proc);
+  } else {
+    k_runqueue_remove(k_run_level(proc), proc->pid);
+  }
+}
+
+bool k_runqueue_contains(pcb* proc) {
+  if (proc->rt_period > 0) {
+    return k_edf_contains(proc);
+  } else if (proc->cgroup != CGROUP_ROOT) {
+    return k_cgroup_contains(proc);
+  } else if (policy == SCHED_CFS) {
+    return k_cfs_contains(proc);
+  }
+  return PIDDequeJobSearch(priorityList[k_run_level(proc)], proc->pid);
+}
+
+int k_runqueue_depth(int level) {
+  int grouped = k_cgroup_depth(level);
+  if (policy == SCHED_CFS) {
+    return k_cfs_depth(level) + grouped;
+  }
+  return PIDDeque_Size(priorityList[level]) + grouped;
+}
+
+int k_runqueue_draw(uint32_t set) {
+  if (set == 0) {
+    return -1;
+  }
+  // a single level needs no draw
+  if ((set & (set - 1)) == 0) {
+    return __builtin_ctz(set);
+  }
+  int draw = rand() % set_weight[set];
+  while (true) {
+    int level = __builtin_ctz(set);
+    if (draw < weights[level] || (set & (set - 1)) == 0) {
+      return level;
+    }
+    draw -= weights[level];
+    set &= set - 1;
+  }
+}
+
+pid_t k_runqueue_next_best_effort() {
+  if (policy == SCHED_CFS) {
+    return k_cfs_next();
+  }
+  int level = k_runqueue_draw(nonempty);
+  pid_t pid = -1;
+  if (level != -1) {
+    k_runqueue_pop_front(level, &pid);
+  }
+  return pid;
+}
+
+pid_t k_runqueue_next() {
+  pid_t rt = k_edf_next();
+  if (rt != -1) {
+    return rt;
+  }
+  return k_cgroup_next();
+}
@@ -0,0 +1,148 @@
+#ifndef RUNQUEUE_H
+#define RUNQUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Run queues. priorityList[0 .. levels-1] hold the runnable jobs of each
+// priority level. The number of levels and their lottery weights are set at
+// boot (3 levels weighted 9:6:4 by default). Every push and pop goes through
+// these functions so that a bitmap of the non-empty levels stays current, and
+// the scheduler's weighted pick only visits the levels set in it.
+//
+// The policy is also chosen at boot: the lottery over these queues, or
+// virtual-runtime scheduling (see cfs.h), which uses the same weights. These
+// queues hold the jobs of the root CPU group; other groups keep their own.
+///////////////////////////////////////////////////////////////////////////////
+
+#define RUNQUEUE_DEFAULT_WEIGHTS "9,6,4"
+
+#define SCHED_LOTTERY 0
+#define SCHED_CFS 1
+
+/**
+ * @brief Sets the scheduling policy by name, "lottery" (the default) or
+ * "cfs". Must be called before any job is created.
+ *
+ * @return 0 on success, -1 if the name is not a policy
+ */
+int k_sched_set_policy(const char* name);
+
+/**
+ * @brief Returns the scheduling policy, SCHED_LOTTERY or SCHED_CFS.
+ */
+int k_sched_policy(void);
+
+/**
+ * @brief Sets the number of priority levels and their weights from a comma
+ * separated list, e.g. "9,6,4" or "8,4,2,1". Must be called before any job
+ * is created.
+ *
+ * @return 0 on success, -1 if the list is malformed, has more than
+ * MAX_PRIORITY_LEVELS entries or a weight is not positive
+ */
+int k_levels_parse(const char* weights);
+
+/**
+ * @brief Returns the number of priority levels, applying the default levels
+ * if k_levels_parse was never called.
+ */
+int k_num_levels(void);
+
+/**
+ * @brief Returns the lottery weight of a priority level.
+ */
+int k_level_weight(int level);
+
+/**
+ * @brief Clears the bitmap for freshly allocated run queues. Called from
+ * k_allocate_lists.
+ */
+void k_runqueue_init(void);
+
+/**
+ * @brief Pushes a pid onto the back of a run queue.
+ */
+void k_runqueue_push_back(int level, pid_t pid);
+
+/**
+ * @brief Pushes a pid onto the front of a run queue.
+ */
+void k_runqueue_push_front(int level, pid_t pid);
+
+/**
+ * @brief Looks at the pid at the front of a run queue without removing it.
+ *
+ * @return true on success, false if the queue is empty
+ */
+bool k_runqueue_peek_front(int level, pid_t* pid);
+
+/**
+ * @brief Pops the pid at the front of a run queue.
+ *
+ * @return true on success, false if the queue is empty
+ */
+bool k_runqueue_pop_front(int level, pid_t* pid);
+
+/**
+ * @brief Removes a pid from a run queue in O(1).
+ *
+ * @return true if the pid was in the queue
+ */
+bool k_runqueue_remove(int level, pid_t pid);
+
+/**
+ * @brief Makes a job runnable at its current run level under the policy in
+ * use, or in the real-time class if it has a period.
+ */
+void k_runqueue_enqueue(pcb* proc);
+
+/**
+ * @brief Removes a job from the runnable jobs, if it is runnable.
+ */
+void k_runqueue_dequeue(pcb* proc);
+
+/**
+ * @brief Returns whether a job is runnable, wherever the policy in use, its
+ * CPU group or its real-time class queues it.
+ */
+bool k_runqueue_contains(pcb* proc);
+
+/**
+ * @brief Removes the next job to run. Ready real-time jobs (see edf.h) come
+ * first. Otherwise a CPU group is picked and then a job within it (see
+ * cgroup.h).
+ *
+ * @return the job's pid, or -1 if no job is runnable
+ */
+pid_t k_runqueue_next(void);
+
+/**
+ * @brief Removes the next best-effort job of the root CPU group. Under the
+ * lottery, a non-empty level is drawn with probability proportional to its
+ * weight among the non-empty levels and its front job is taken. Only the
+ * levels in the bitmap are visited, and the total weight of each set of
+ * levels is precomputed. Under cfs the job with the least vruntime is taken.
+ *
+ * @return the job's pid, or -1 if no such job is runnable
+ */
+pid_t k_runqueue_next_best_effort(void);
+
+/**
+ * @brief Draws one level of a set of levels with probability proportional to
+ * its weight, as the lottery does.
+ *
+ * @param set a bitmap of levels
+ * @return the level, or -1 if the set is empty
+ */
+int k_runqueue_draw(uint32_t set);
+
+/**
+ * @brief Returns the number of runnable jobs at a level.
+ */
+int k_runqueue_depth(int level);
+
+#endif
@@ -0,0 +1,113 @@
+#include "schedstat.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "kernel.h"
+#include "runqueue.h"
+
+static latency_histogram histograms[SCHEDSTAT_NUM_PRIORITIES];
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Maps a value to its log-linear bucket
+static int bucket_index(uint64_t value) {
+  if (value < SCHEDSTAT_SUB_COUNT) {
+    return (int)value;
+  }
+  int exponent = 63 - __builtin_clzll(value);
+  int shift = exponent - SCHEDSTAT_SUB_BITS;
+  int sub = (int)(value >> shift) - SCHEDSTAT_SUB_COUNT;
+  return SCHEDSTAT_SUB_COUNT + shift * SCHEDSTAT_SUB_COUNT + sub;
+}
+
+// Largest value which maps to the given bucket
+static uint64_t bucket_upper(int index) {
+  if (index < SCHEDSTAT_SUB_COUNT) {
+    return (uint64_t)index;
+  }
+  int shift = (index - SCHEDSTAT_SUB_COUNT) / SCHEDSTAT_SUB_COUNT;
+  uint64_t sub =
+      (uint64_t)((index - SCHEDSTAT_SUB_COUNT) % SCHEDSTAT_SUB_COUNT);
+  return ((SCHEDSTAT_SUB_COUNT + sub + 1) << shift) - 1;
+}
+
+void k_schedstat_runnable(pcb* proc) {
+  proc->runnable_ns = now_ns();
+}
+
+void k_schedstat_dispatch(pcb* proc, int priority) {
+  if (proc->runnable_ns == 0 || priority < 0 ||
+      priority >= SCHEDSTAT_NUM_PRIORITIES) {
+    return;
+  }
+  uint64_t latency = now_ns() - proc->runnable_ns;
+  proc->runnable_ns = 0;
+
+  latency_histogram* hist = &histograms[priority];
+  hist->counts[bucket_index(latency)]++;
+  if (hist->total == 0 || latency < hist->min_ns) {
+    hist->min_ns = latency;
+  }
+  if (latency > hist->max_ns) {
+    hist->max_ns = latency;
+  }
+  hist->total++;
+  hist->sum_ns += latency;
+}
+
+uint64_t k_schedstat_percentile(latency_histogram* hist, double percentile) {
+  if (hist->total == 0) {
+    return 0;
+  }
+  uint64_t target = (uint64_t)((percentile / 100.0) * hist->total + 0.5);
+  if (target == 0) {
+    target = 1;
+  }
+  uint64_t seen = 0;
+  for (int i = 0; i < SCHEDSTAT_NUM_BUCKETS; i++) {
+    seen += hist->counts[i];
+    if (seen >= target) {
+      uint64_t upper = bucket_upper(i);
+      return upper < hist->max_ns ? upper : hist->max_ns;
+    }
+  }
+  return hist->max_ns;
+}
+
+// Formats one row of the latency table (all latencies in microseconds)
+static void format_row(int priority, char* buf, size_t size) {
+  latency_histogram* hist = &histograms[priority];
+  uint64_t mean = hist->total == 0 ? 0 : hist->sum_ns / hist->total;
+  snprintf(buf, size, "%d\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\n", priority,
+           hist->total, hist->min_ns / 1000, mean / 1000,
+           k_schedstat_percentile(hist, 50) / 1000,
+           k_schedstat_percentile(hist, 90) / 1000,
+           k_schedstat_percentile(hist, 99) / 1000, hist->max_ns / 1000);
+}
+
+static const char* header = "PRI\tCOUNT\tMIN(us)\tMEAN\tP50\tP90\tP99\tMAX\n";
+
+void k_schedstat(int fd) {
+  k_write(fd, header, strlen(header));
+  for (int i = 0; i < k_num_levels(); i++) {
+    char row[200];
+    format_row(i, row, sizeof(row));
+    k_write(fd, row, strlen(row));
+  }
+}
+
+void k_schedstat_dump() {
+  char message[100];
+  sprintf(message, "[%3d]\tSCHEDSTAT\n", ticks);
+  k_write_log(message);
+  k_write_log((char*)header);
+  for (int i = 0; i < k_num_levels(); i++) {
+    char row[200];
+    format_row(i, row, sizeof(row));
+    k_write_log(row);
+  }
+}
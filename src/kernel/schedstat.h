@@ -0,0 +1,68 @@
+#ifndef SCHEDSTAT_H
+#define SCHEDSTAT_H
+
+#include <stdint.h>
+#include "../util/PCB.h"
+#include "../util/macros.h"
+
+// HDR-style log-linear buckets: values below 2^SCHEDSTAT_SUB_BITS get a bucket
+// each, and every power of two above that is split into 2^SCHEDSTAT_SUB_BITS
+// linear sub-buckets, keeping the relative error of any bucket under ~3%.
+#define SCHEDSTAT_SUB_BITS 5
+#define SCHEDSTAT_SUB_COUNT (1 << SCHEDSTAT_SUB_BITS)
+#define SCHEDSTAT_NUM_BUCKETS \
+  ((64 - SCHEDSTAT_SUB_BITS + 1) * SCHEDSTAT_SUB_COUNT)
+
+// Number of priority levels that can get their own histogram
+#define SCHEDSTAT_NUM_PRIORITIES MAX_PRIORITY_LEVELS
+
+// Dispatch latency histogram for one priority level, in nanoseconds
+typedef struct latency_histogram {
+  uint64_t counts[SCHEDSTAT_NUM_BUCKETS];
+  uint64_t total;
+  uint64_t sum_ns;
+  uint64_t min_ns;
+  uint64_t max_ns;
+} latency_histogram;
+
+/**
+ * @brief Records that a job has just become runnable (pushed onto one of the
+ * priority queues). Called on every runnable transition.
+ *
+ * @param proc the job which became runnable
+ */
+void k_schedstat_runnable(pcb* proc);
+
+/**
+ * @brief Records that the scheduler has dispatched a job, adding the time it
+ * spent runnable to the histogram of the priority it was picked from.
+ *
+ * @param proc the job being dispatched
+ * @param priority the priority queue the job was taken from
+ */
+void k_schedstat_dispatch(pcb* proc, int priority);
+
+/**
+ * @brief Returns the value (in ns) at the given percentile of a histogram.
+ *
+ * @param hist the histogram to query
+ * @param percentile a value between 0 and 100
+ * @return the upper bound of the bucket holding the percentile, 0 if empty
+ */
+uint64_t k_schedstat_percentile(latency_histogram* hist, double percentile);
+
+/**
+ * @brief Writes the per-priority latency table to a PennOS file descriptor.
+ * Used by the `schedstat` builtin.
+ *
+ * @param fd file descriptor to write to
+ */
+void k_schedstat(int fd);
+
+/**
+ * @brief Writes the per-priority latency table to the log file. Called when
+ * PennOS shuts down.
+ */
+void k_schedstat_dump(void);
+
+#endif
@@ -18,6 +18,11 @@ static BuiltinMap function_map[] = {
     {"sleep", os_sleep},
     {"busy", busy},
     {"ps", ps},
+    {"schedstat", schedstat},
+    {"cgstat", cgstat},
+    {"syncstat", syncstat},
+    {"shmstat", shmstat},
+    {"mqstat", mqstat},
     {"kill", os_kill},
     {"cat", cat},
     {"echo", echo},
@@ -34,6 +39,14 @@ static BuiltinMap function_map[] = {
     {"recur", recur},
     {"nice", u_nice},
     {"nice_pid", nice_pid},
+    {"rt_pid", rt_pid},
+    {"aging", aging},
+    {"cgroup", cgroup},
+    {"sem", sem},
+    {"semstress", semstress},
+    {"shm", shm},
+    {"shmfan", shmfan},
+    {"mq", mq},
     {"zombify", zombify},
     {"orphanify", orphanify},
     {"jobs", jobs},
@@ -80,6 +93,15 @@ bool is_shell_builtin(struct parsed_command* parsed) {
   if (strcmp(parsed->commands[0][0], "nice_pid") == 0) {
     nice_pid(parsed->commands[0]);
     return true;
+  } else if (strcmp(parsed->commands[0][0], "rt_pid") == 0) {
+    rt_pid(parsed->commands[0]);
+    return true;
+  } else if (strcmp(parsed->commands[0][0], "aging") == 0) {
+    aging(parsed->commands[0]);
+    return true;
+  } else if (strcmp(parsed->commands[0][0], "cgroup") == 0) {
+    cgroup(parsed->commands[0]);
+    return true;
   } else if (strcmp(parsed->commands[0][0], "man") == 0) {
     // cast output_file and pass in to man
     man((void*)(intptr_t)output_file);
@@ -351,6 +373,14 @@ void* shell(void* arg) {
           child = s_spawn(os_proc_func_script, script_parsed->commands[0],
                           input_file, output_file, process_name_script, false,
                           script_parsed);
+          if (child == -1) {
+            u_error(process_name_script);
+            free(script_parsed);
+            script_parsed = NULL;
+            individual_command = strtok(NULL, "\n");
+            continue;
+          }
+          s_setpgid(child, child);
 
           int child_status = -1;
           if (s_waitpid(child, &child_status, false) < 0) {
@@ -450,6 +480,21 @@ void* shell(void* arg) {
       pid_t child =
           s_spawn(os_proc_func, actual_command, input_file, output_file,
                   process_name, parsed->is_background, parsed);
+      if (child == -1) {
+        u_error("nice");
+        free(parsed);
+        parsed = NULL;
+
+        if (input_file != STDIN_FILENO) {
+          s_close(input_file);
+        }
+        if (output_file != STDOUT_FILENO) {
+          s_close(output_file);
+        }
+
+        continue;
+      }
+      s_setpgid(child, child);
       int child_status = -1;
 
       // Assign the priority
@@ -483,11 +528,19 @@ void* shell(void* arg) {
       pid_t child =
           s_spawn(os_proc_func, parsed->commands[0], input_file, output_file,
                   process_name, parsed->is_background, parsed);
+      if (child == -1) {
+        u_error(process_name);
+        free(parsed);
+        parsed = NULL;
+      } else {
+        // each job gets its own process group, so ^C and ^Z reach all of it
+        s_setpgid(child, child);
+      }
 
       int child_status = -1;
 
       // only wait if the job is in the foreground
-      if (!parsed->is_background) {
+      if (child != -1 && !parsed->is_background) {
         if (s_waitpid(child, &child_status, false) < 0) {
           free(parsed);
           parsed = NULL;
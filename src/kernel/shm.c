@@ -0,0 +1,158 @@
+#include "shm.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../util/PIDDeque.h"
+#include "kernel.h"
+
+typedef struct shm_segment {
+  bool in_use;
+  bool deleted;  // no longer found by name, freed with its last mapping
+  char name[SHM_NAME_MAX];
+  void* addr;
+  size_t size;
+  PIDDeque* mappers;  // processes that have the segment mapped
+} shm_segment;
+
+static shm_segment segments[SHM_MAX];
+
+void k_shm_init() {
+  memset(segments, 0, sizeof(segments));
+}
+
+static void segment_free(shm_segment* seg) {
+  munmap(seg->addr, seg->size);
+  PIDDeque_Free(seg->mappers);
+  seg->mappers = NULL;
+  seg->in_use = false;
+}
+
+void k_shm_free() {
+  for (int id = 0; id < SHM_MAX; id++) {
+    if (segments[id].in_use) {
+      segment_free(&segments[id]);
+    }
+  }
+}
+
+static int lookup(const char* name) {
+  for (int id = 0; id < SHM_MAX; id++) {
+    if (segments[id].in_use && !segments[id].deleted &&
+        strcmp(segments[id].name, name) == 0) {
+      return id;
+    }
+  }
+  return -1;
+}
+
+static int segment_create(const char* name, size_t size) {
+  size_t page = sysconf(_SC_PAGESIZE);
+  size = (size + page - 1) / page * page;
+  for (int id = 0; id < SHM_MAX; id++) {
+    shm_segment* seg = &segments[id];
+    if (seg->in_use) {
+      continue;
+    }
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      return -1;
+    }
+    *seg = (shm_segment){
+        .in_use = true,
+        .addr = addr,
+        .size = size,
+        .mappers = PIDDeque_Allocate(),
+    };
+    snprintf(seg->name, sizeof(seg->name), "%s", name);
+    return id;
+  }
+  return -1;
+}
+
+int k_shm_open(const char* name, size_t size, bool create) {
+  size_t len = strlen(name);
+  if (len == 0 || len >= SHM_NAME_MAX || size > SHM_SIZE_MAX) {
+    return -1;
+  }
+  int id = lookup(name);
+  if (id == -1) {
+    return create && size > 0 ? segment_create(name, size) : -1;
+  }
+  return segments[id].size >= size ? id : -1;
+}
+
+void* k_shm_map(int id, size_t* size) {
+  pcb* proc = k_get_proc();
+  if (id < 0 || id >= SHM_MAX || !segments[id].in_use || proc == NULL) {
+    return NULL;
+  }
+  shm_segment* seg = &segments[id];
+  if (!PIDDequeJobSearch(seg->mappers, proc->pid)) {
+    PIDDeque_Push_Back(seg->mappers, proc->pid);
+  }
+  if (size != NULL) {
+    *size = seg->size;
+  }
+  return seg->addr;
+}
+
+// Drops a process's mapping of a segment, freeing the segment if it was
+// deleted and nobody else has it mapped
+static void drop(shm_segment* seg, pid_t pid) {
+  if (PIDSearchAndDelete(seg->mappers, pid) && seg->deleted &&
+      PIDDeque_Size(seg->mappers) == 0) {
+    segment_free(seg);
+  }
+}
+
+int k_shm_unmap(void* addr) {
+  pcb* proc = k_get_proc();
+  for (int id = 0; id < SHM_MAX && proc != NULL; id++) {
+    shm_segment* seg = &segments[id];
+    if (seg->in_use && seg->addr == addr &&
+        PIDDequeJobSearch(seg->mappers, proc->pid)) {
+      drop(seg, proc->pid);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int k_shm_unlink(const char* name) {
+  int id = lookup(name);
+  if (id == -1) {
+    return -1;
+  }
+  shm_segment* seg = &segments[id];
+  seg->deleted = true;
+  if (PIDDeque_Size(seg->mappers) == 0) {
+    segment_free(seg);
+  }
+  return 0;
+}
+
+void k_shm_forget(pcb* proc) {
+  for (int id = 0; id < SHM_MAX; id++) {
+    if (segments[id].in_use) {
+      drop(&segments[id], proc->pid);
+    }
+  }
+}
+
+void k_shm_print(int fd) {
+  char* header = "ID\tSIZE\tMAPS\tNAME\n";
+  k_write(fd, header, strlen(header));
+  for (int id = 0; id < SHM_MAX; id++) {
+    shm_segment* seg = &segments[id];
+    if (!seg->in_use) {
+      continue;
+    }
+    char row[96];
+    snprintf(row, sizeof(row), "%d\t%zu\t%d\t%s%s\n", id, seg->size,
+             PIDDeque_Size(seg->mappers), seg->name,
+             seg->deleted ? " (deleted)" : "");
+    k_write(fd, row, strlen(row));
+  }
+}
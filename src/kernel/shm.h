@@ -0,0 +1,83 @@
+#ifndef SHM_H
+#define SHM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Shared-memory segments. A segment is an anonymous host mapping owned by
+// the kernel and looked up by name; since every PennOS process is a thread
+// of the host process, a process that maps a segment just gets its address,
+// so processes can pass large buffers to each other without copying them
+// through PennFAT.
+//
+// A segment counts the processes that have it mapped; mapping it again from
+// the same process returns the same address without counting twice. Like a
+// POSIX segment it outlives its mappers until it is deleted, and a deleted
+// segment can no longer be opened but stays mapped until its last mapper
+// unmaps it or is cleaned up, when its memory is returned to the host.
+///////////////////////////////////////////////////////////////////////////////
+
+#define SHM_MAX 32  // segments that can exist at once
+#define SHM_NAME_MAX 16
+#define SHM_SIZE_MAX (64 << 20)  // bytes
+
+/**
+ * @brief Empties the segment table. Called from k_allocate_lists.
+ */
+void k_shm_init(void);
+
+/**
+ * @brief Unmaps every segment, mapped or not.
+ */
+void k_shm_free(void);
+
+/**
+ * @brief Looks a segment up by name, creating it if there is none and
+ * create is set. A new segment is zero-filled and its size rounded up to
+ * whole pages.
+ *
+ * @param size the size the segment must have at least, at most SHM_SIZE_MAX
+ * @return its id, or -1 if there is no such segment and create is not set,
+ * the segment is smaller than size, an argument is invalid, SHM_MAX
+ * segments exist or the host mapping failed
+ */
+int k_shm_open(const char* name, size_t size, bool create);
+
+/**
+ * @brief Maps a segment into the calling process.
+ *
+ * @param size set to the segment's size if not NULL
+ * @return its address, or NULL if the segment does not exist
+ */
+void* k_shm_map(int id, size_t* size);
+
+/**
+ * @brief Unmaps the segment at addr from the calling process, freeing it if
+ * it was deleted and this was its last mapping.
+ *
+ * @return 0 on success, -1 if the process has no segment mapped at addr
+ */
+int k_shm_unmap(void* addr);
+
+/**
+ * @brief Deletes a segment: it can no longer be opened and is freed once it
+ * is no longer mapped.
+ *
+ * @return 0 on success, -1 if there is no such segment
+ */
+int k_shm_unlink(const char* name);
+
+/**
+ * @brief Unmaps every segment a process that is being cleaned up has mapped.
+ */
+void k_shm_forget(pcb* proc);
+
+/**
+ * @brief Writes one line per segment: its size, number of mappings, and
+ * whether it was deleted.
+ */
+void k_shm_print(int fd);
+
+#endif
@@ -0,0 +1,84 @@
+#include "signal_queue.h"
+#include "../util/PCBDeque.h"
+#include "../util/PIDDeque.h"
+#include "../util/macros.h"
+#include "job_control.h"
+#include "kernel.h"
+
+#define SIGNAL_BIT(signal) (1u << ((signal) - P_SIGSTOP))
+
+static PIDDeque* signalled = NULL;  // processes with a pending signal, once
+
+void k_signals_init() {
+  signalled = PIDDeque_Allocate();
+}
+
+void k_signals_free() {
+  PIDDeque_Free(signalled);
+  signalled = NULL;
+}
+
+static void post(pcb* proc, int signal) {
+  // a stop cancels a pending continue and the other way round
+  unsigned int cancels = signal == P_SIGSTOP   ? SIGNAL_BIT(P_SIGCONT)
+                         : signal == P_SIGCONT ? SIGNAL_BIT(P_SIGSTOP)
+                                               : 0;
+  unsigned int old = atomic_load(&proc->pending_signals);
+  while (!atomic_compare_exchange_weak(&proc->pending_signals, &old,
+                                       (old & ~cancels) | SIGNAL_BIT(signal))) {
+  }
+  // only the post that finds nothing pending queues the process; one that
+  // swaps a stop for a continue finds it queued already
+  if (old == 0) {
+    PIDDeque_Push_Back(signalled, proc->pid);
+  }
+}
+
+int k_post_signal(pid_t pid, int signal) {
+  pcb* proc = PCBDequeJobSearch(PCBList, pid);
+  if (proc == NULL) {
+    return -1;
+  }
+  post(proc, signal);
+  return 0;
+}
+
+int k_post_signal_group(pid_t pgid, int signal) {
+  PIDDeque* members = k_pgrp_members(pgid);
+  if (members == NULL) {
+    return -1;
+  }
+  pid_t pid;
+  for (uint32_t it = PIDDeque_Begin(members);
+       PIDDeque_Next(members, &it, &pid);) {
+    pcb* proc = PCBDequeJobSearch(PCBList, pid);
+    if (proc != NULL) {
+      post(proc, signal);
+    }
+  }
+  return 0;
+}
+
+void k_deliver_signals() {
+  pid_t pid;
+  while (PIDDeque_Pop_Front(signalled, &pid)) {
+    pcb* proc = PCBDequeJobSearch(PCBList, pid);
+    if (proc == NULL) {
+      continue;
+    }
+    unsigned int pending = atomic_exchange(&proc->pending_signals, 0);
+    if (pending & SIGNAL_BIT(P_SIGTERM)) {
+      k_send_signal(pid, P_SIGTERM);
+    } else if (pending & SIGNAL_BIT(P_SIGSTOP)) {
+      k_send_signal(pid, P_SIGSTOP);
+    } else if (pending & SIGNAL_BIT(P_SIGCONT)) {
+      k_send_signal(pid, P_SIGCONT);
+    }
+  }
+}
+
+void k_signals_forget(pcb* proc) {
+  if (atomic_exchange(&proc->pending_signals, 0) != 0) {
+    PIDSearchAndDelete(signalled, proc->pid);
+  }
+}
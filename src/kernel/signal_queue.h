@@ -0,0 +1,50 @@
+#ifndef SIGNAL_QUEUE_H
+#define SIGNAL_QUEUE_H
+
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Deferred signal delivery. Posting a signal only sets a bit in the target's
+// pending_signals bitmap, and queues the target once, so it is safe from
+// contexts that must not touch the scheduler's lists. The scheduler delivers
+// everything pending at the start of each tick.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Allocates the queue of processes with pending signals. Called from
+ * k_allocate_lists.
+ */
+void k_signals_init(void);
+
+/**
+ * @brief Frees the pending signal queue.
+ */
+void k_signals_free(void);
+
+/**
+ * @brief Marks a signal pending for a process. A pending P_SIGSTOP discards a
+ * pending P_SIGCONT and the other way around, so the later one wins.
+ *
+ * @return 0 on success, -1 if the process does not exist
+ */
+int k_post_signal(pid_t pid, int signal);
+
+/**
+ * @brief Marks a signal pending for every member of a process group.
+ *
+ * @return 0 on success, -1 if the group does not exist
+ */
+int k_post_signal_group(pid_t pgid, int signal);
+
+/**
+ * @brief Delivers every pending signal with k_send_signal, P_SIGTERM taking
+ * precedence over the others. Called by the scheduler at the start of a tick.
+ */
+void k_deliver_signals(void);
+
+/**
+ * @brief Drops the pending signals of a process that is being cleaned up.
+ */
+void k_signals_forget(pcb* proc);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SUBMIT_H
+#define SUBMIT_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Batched file system calls. A process fills an array of submission entries
+// and hands the whole array to s_submit, which carries them out and leaves
+// each entry's result in it, so one call does the work of many.
+//
+// Every PennFAT call starts by walking the root directory with small reads
+// of the host file, so the entries are grouped before any I/O is done: a run
+// of touches is done in a single pass over the directory, reading and
+// writing each of its blocks once, and a run of writes to the same
+// descriptor is joined into one write; an entry of that run with a negative
+// n or no buffer fails with EARG and is left out. Everything else runs on
+// its own, in the order given; results come back as if each entry had been
+// a call of its own.
+///////////////////////////////////////////////////////////////////////////////
+
+#define P_SUB_TOUCH 0   // fname
+#define P_SUB_OPEN 1    // fname, mode; res is the new descriptor
+#define P_SUB_READ 2    // fd, buf, n; res is the number of bytes read
+#define P_SUB_WRITE 3   // fd, buf, n; res is the number of bytes written
+#define P_SUB_LSEEK 4   // fd, n as the offset, mode as the whence
+#define P_SUB_CLOSE 5   // fd
+#define P_SUB_UNLINK 6  // fname
+
+typedef struct p_subentry {
+  int op;  // one of the P_SUB_ codes
+  int fd;
+  char* fname;
+  char* buf;
+  int n;
+  int mode;
+  int res;  // set by s_submit: what the call alone would have returned
+  int err;  // set by s_submit: P_ERRNO if res is -1, 0 otherwise
+} p_subentry;
+
+#endif
@@ -0,0 +1,224 @@
+#include "sync.h"
+#include <stdio.h>
+#include <string.h>
+#include "../util/PCBDeque.h"
+#include "../util/PIDDeque.h"
+#include "../util/macros.h"
+#include "kernel.h"
+
+typedef struct sync_object {
+  bool in_use;
+  sync_kind kind;
+  bool by_priority;  // wake the best run level first rather than the oldest
+  char name[SYNC_NAME_MAX];
+  int value;         // units left; for a mutex 1 while unlocked
+  pid_t owner;       // process holding the mutex, -1 if none
+  PIDDeque* waiters;  // blocked processes in arrival order
+  long taken;        // # units taken, including hand-offs
+  long blocked;      // # times a process had to wait
+  long handoffs;     // # units passed straight to a waiter
+} sync_object;
+
+static sync_object objects[SYNC_MAX];
+
+void k_sync_init() {
+  memset(objects, 0, sizeof(objects));
+}
+
+static void object_free(sync_object* obj) {
+  PIDDeque_Free(obj->waiters);
+  obj->waiters = NULL;
+  obj->in_use = false;
+}
+
+void k_sync_free() {
+  for (int id = 0; id < SYNC_MAX; id++) {
+    if (objects[id].in_use) {
+      object_free(&objects[id]);
+    }
+  }
+}
+
+static sync_object* get(int id, sync_kind kind) {
+  if (id < 0 || id >= SYNC_MAX || !objects[id].in_use ||
+      objects[id].kind != kind) {
+    return NULL;
+  }
+  return &objects[id];
+}
+
+int k_sync_lookup(const char* name, sync_kind kind) {
+  for (int id = 0; id < SYNC_MAX; id++) {
+    if (objects[id].in_use && objects[id].kind == kind &&
+        strcmp(objects[id].name, name) == 0) {
+      return id;
+    }
+  }
+  return -1;
+}
+
+int k_sync_create(const char* name, sync_kind kind, int value,
+                  bool by_priority) {
+  size_t len = strlen(name);
+  if (len == 0 || len >= SYNC_NAME_MAX || value < 0 ||
+      value > SYNC_VALUE_MAX || (kind == SYNC_MUTEX && value != 1) ||
+      k_sync_lookup(name, kind) != -1) {
+    return -1;
+  }
+  for (int id = 0; id < SYNC_MAX; id++) {
+    sync_object* obj = &objects[id];
+    if (!obj->in_use) {
+      *obj = (sync_object){
+          .in_use = true,
+          .kind = kind,
+          .by_priority = by_priority,
+          .value = value,
+          .owner = -1,
+          .waiters = PIDDeque_Allocate(),
+      };
+      snprintf(obj->name, sizeof(obj->name), "%s", name);
+      return id;
+    }
+  }
+  return -1;
+}
+
+int k_sync_destroy(int id, sync_kind kind) {
+  sync_object* obj = get(id, kind);
+  if (obj == NULL || PIDDeque_Size(obj->waiters) > 0 || obj->owner != -1) {
+    return -1;
+  }
+  object_free(obj);
+  return 0;
+}
+
+// Whether a is to be woken before b, which arrived earlier
+static bool before(pcb* a, pcb* b) {
+  bool a_rt = a->rt_period > 0;
+  bool b_rt = b->rt_period > 0;
+  if (a_rt != b_rt) {
+    return a_rt;
+  }
+  return k_run_level(a) < k_run_level(b);
+}
+
+// Removes the waiter to hand the next unit to, -1 if there is none
+static pid_t next_waiter(sync_object* obj) {
+  pid_t pid;
+  if (!obj->by_priority) {
+    return PIDDeque_Pop_Front(obj->waiters, &pid) ? pid : -1;
+  }
+  pcb* best = NULL;
+  for (uint32_t it = PIDDeque_Begin(obj->waiters);
+       PIDDeque_Next(obj->waiters, &it, &pid);) {
+    pcb* proc = PCBDequeJobSearch(PCBList, pid);
+    if (proc != NULL && (best == NULL || before(proc, best))) {
+      best = proc;
+    }
+  }
+  if (best == NULL) {
+    return -1;
+  }
+  PIDSearchAndDelete(obj->waiters, best->pid);
+  return best->pid;
+}
+
+// Gives a unit back, to the next waiter if there is one
+static void release(sync_object* obj) {
+  pid_t next = next_waiter(obj);
+  if (next == -1) {
+    obj->value++;
+    obj->owner = -1;
+    return;
+  }
+  obj->taken++;
+  obj->handoffs++;
+  if (obj->kind == SYNC_MUTEX) {
+    obj->owner = next;
+  }
+  pcb* proc = PCBDequeJobSearch(PCBList, next);
+  if (proc != NULL) {
+    k_unblock(proc);
+  }
+}
+
+int k_sync_acquire(int id, sync_kind kind, bool try) {
+  sync_object* obj = get(id, kind);
+  pcb* proc = k_get_proc();
+  if (obj == NULL || proc == NULL || obj->owner == proc->pid) {
+    return -1;
+  }
+  if (obj->value > 0) {
+    obj->value--;
+    obj->taken++;
+    if (kind == SYNC_MUTEX) {
+      obj->owner = proc->pid;
+    }
+    return 0;
+  }
+  if (try) {
+    return 1;
+  }
+  obj->blocked++;
+  PIDDeque_Push_Back(obj->waiters, proc->pid);
+  // a waiter continued after a stop runs again before its unit arrives
+  while (objects[id].in_use &&
+         PIDDequeJobSearch(objects[id].waiters, proc->pid)) {
+    k_block(proc);
+    spthread_suspend(proc->curr_thread);
+  }
+  return 0;
+}
+
+int k_sync_release(int id, sync_kind kind) {
+  sync_object* obj = get(id, kind);
+  pcb* proc = k_get_proc();
+  if (obj == NULL || proc == NULL) {
+    return -1;
+  }
+  if (kind == SYNC_MUTEX ? obj->owner != proc->pid
+                         : obj->value == SYNC_VALUE_MAX) {
+    return -1;
+  }
+  release(obj);
+  return 0;
+}
+
+void k_sync_forget(pcb* proc) {
+  for (int id = 0; id < SYNC_MAX; id++) {
+    sync_object* obj = &objects[id];
+    if (!obj->in_use) {
+      continue;
+    }
+    PIDSearchAndDelete(obj->waiters, proc->pid);
+    if (obj->owner == proc->pid) {
+      release(obj);
+    }
+  }
+}
+
+void k_sync_print(int fd) {
+  char* header = "ID\tKIND\tVALUE\tWAIT\tTAKEN\tBLOCKED\tHANDOFF\tNAME\n";
+  k_write(fd, header, strlen(header));
+  for (int id = 0; id < SYNC_MAX; id++) {
+    sync_object* obj = &objects[id];
+    if (!obj->in_use) {
+      continue;
+    }
+    char value[16];
+    if (obj->kind == SYNC_SEM) {
+      snprintf(value, sizeof(value), "%d", obj->value);
+    } else if (obj->owner != -1) {
+      snprintf(value, sizeof(value), "@%d", obj->owner);
+    } else {
+      snprintf(value, sizeof(value), "-");
+    }
+    char row[128];
+    snprintf(row, sizeof(row), "%d\t%s%s\t%s\t%d\t%ld\t%ld\t%ld\t%s\n", id,
+             obj->kind == SYNC_SEM ? "sem" : "mutex",
+             obj->by_priority ? "/p" : "", value,
+             PIDDeque_Size(obj->waiters), obj->taken, obj->blocked,
+             obj->handoffs, obj->name);
+    k_write(fd, row, strlen(row));
+  }
+}
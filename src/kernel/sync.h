@@ -0,0 +1,100 @@
+#ifndef SYNC_H
+#define SYNC_H
+
+#include <stdbool.h>
+#include "../util/PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Counting semaphores and mutexes shared by name between processes. A
+// process that has to wait joins the object's wait queue and blocks like a
+// process in waitpid, so it takes no run queue slot and burns no quanta
+// until the unit it waits for is handed to it.
+//
+// A post or unlock with waiters passes the unit straight to the next waiter
+// instead of raising the count, so a process that comes along in between
+// cannot take it first and the woken process never finds it gone. The next
+// waiter is the oldest one, or for objects created by priority the one at
+// the best run level (real-time jobs first), the oldest among equals. A
+// mutex has an owner, which alone may unlock it and which must not lock it
+// again; a process that exits or is killed leaves every wait queue and
+// unlocks the mutexes it holds.
+///////////////////////////////////////////////////////////////////////////////
+
+#define SYNC_MAX 64  // semaphores and mutexes that can exist at once
+#define SYNC_NAME_MAX 16
+#define SYNC_VALUE_MAX 65535
+
+typedef enum { SYNC_SEM, SYNC_MUTEX } sync_kind;
+
+/**
+ * @brief Empties the object table. Called from k_allocate_lists.
+ */
+void k_sync_init(void);
+
+/**
+ * @brief Frees every object's wait queue.
+ */
+void k_sync_free(void);
+
+/**
+ * @brief Creates a semaphore or an unlocked mutex.
+ *
+ * @param name a name of at most SYNC_NAME_MAX - 1 characters, unique among
+ * objects of the same kind
+ * @param value the semaphore's initial count, in [0, SYNC_VALUE_MAX]; 1 for
+ * a mutex
+ * @param by_priority wake waiters by priority rather than in arrival order
+ * @return the object's id, or -1 if an argument is invalid, the name is
+ * taken or SYNC_MAX objects exist
+ */
+int k_sync_create(const char* name, sync_kind kind, int value,
+                  bool by_priority);
+
+/**
+ * @brief Looks an object of a kind up by name.
+ *
+ * @return its id, or -1 if there is no such object
+ */
+int k_sync_lookup(const char* name, sync_kind kind);
+
+/**
+ * @brief Destroys an object nobody waits on or, for a mutex, holds.
+ *
+ * @return 0 on success, -1 if it does not exist, is not of the kind or is in
+ * use
+ */
+int k_sync_destroy(int id, sync_kind kind);
+
+/**
+ * @brief Takes a unit of a semaphore or locks a mutex for the calling
+ * process, blocking it until one is handed over if there is none and try is
+ * false.
+ *
+ * @return 0 once the unit is taken, 1 if there was none and try is set, -1 if
+ * the object does not exist, is not of the kind or is a mutex the caller
+ * already holds
+ */
+int k_sync_acquire(int id, sync_kind kind, bool try);
+
+/**
+ * @brief Posts a semaphore or unlocks a mutex the calling process holds,
+ * handing the unit to the next waiter if there is one.
+ *
+ * @return 0 on success, -1 if the object does not exist, is not of the kind,
+ * is a mutex the caller does not hold or a semaphore at SYNC_VALUE_MAX
+ */
+int k_sync_release(int id, sync_kind kind);
+
+/**
+ * @brief Takes a process that is exiting, terminated or cleaned up out of
+ * every wait queue and unlocks the mutexes it holds.
+ */
+void k_sync_forget(pcb* proc);
+
+/**
+ * @brief Writes one line per object: its kind, count or owner, waiters, and
+ * how often it was taken, had to be waited for and was handed to a waiter.
+ */
+void k_sync_print(int fd);
+
+#endif
@@ -0,0 +1,233 @@
+#include "trace.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../util/globals.h"
+
+#define TRACE_RING_MASK (TRACE_RING_SIZE - 1)
+#define FLUSH_BATCH 256
+#define FLUSH_INTERVAL_NS 5000000  // 5 ms between polls of an empty ring
+
+// A ring slot. `seq` tells producers and the flusher who owns the slot:
+// seq == pos means free for the producer claiming pos, seq == pos + 1 means
+// the record for pos is published and ready to be flushed.
+typedef struct trace_slot {
+  _Atomic uint64_t seq;
+  trace_record rec;
+} trace_slot;
+
+static trace_slot ring[TRACE_RING_SIZE];
+static _Atomic uint64_t head = 0;  // next position to claim (producers)
+static uint64_t tail = 0;          // next position to flush (flusher only)
+static _Atomic uint64_t dropped = 0;  // records lost to a full ring
+static uint64_t reported = 0;         // drops already logged (flusher only)
+static pthread_once_t ring_once = PTHREAD_ONCE_INIT;
+
+static int trace_fd = -1;
+static bool trace_failed = false;  // a write failed; the log is left as is
+static pthread_t flusher;
+static _Atomic bool flusher_running = false;
+static _Atomic bool flusher_stop = false;
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void ring_init() {
+  for (uint64_t i = 0; i < TRACE_RING_SIZE; i++) {
+    atomic_store_explicit(&ring[i].seq, i, memory_order_relaxed);
+  }
+}
+
+// Claims a slot, copies the record in and publishes it. If the ring is full
+// the record is dropped and counted instead: producers include the scheduler
+// and PennOS processes, and a process suspended between claiming a slot and
+// publishing it holds up the flusher until it runs again, so waiting for room
+// could hang the whole OS.
+static void ring_push(const trace_record* rec) {
+  pthread_once(&ring_once, ring_init);
+  uint64_t pos = atomic_load_explicit(&head, memory_order_relaxed);
+  trace_slot* slot;
+  while (true) {
+    slot = &ring[pos & TRACE_RING_MASK];
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    int64_t diff = (int64_t)seq - (int64_t)pos;
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak_explicit(&head, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+      return;
+    } else {
+      pos = atomic_load_explicit(&head, memory_order_relaxed);
+    }
+  }
+  slot->rec = *rec;
+  atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+// Moves up to FLUSH_BATCH published records into out, returns how many
+static int ring_drain(trace_record* out) {
+  int count = 0;
+  while (count < FLUSH_BATCH) {
+    trace_slot* slot = &ring[tail & TRACE_RING_MASK];
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq != tail + 1) {
+      break;
+    }
+    out[count++] = slot->rec;
+    atomic_store_explicit(&slot->seq, tail + TRACE_RING_SIZE,
+                          memory_order_release);
+    tail++;
+  }
+  return count;
+}
+
+// Writes all of buf, so the log never ends part way through a record. After
+// a failed write nothing more is written: a partial record would leave the
+// rest of the log unreadable.
+static bool write_all(const void* buf, size_t n) {
+  size_t done = 0;
+  while (!trace_failed && done < n) {
+    ssize_t res = write(trace_fd, (const char*)buf + done, n - done);
+    if (res == -1 && errno == EINTR) {
+      continue;
+    }
+    if (res <= 0) {
+      trace_failed = true;
+      break;
+    }
+    done += res;
+  }
+  return !trace_failed;
+}
+
+// Writes a TRACE_DROPPED record for the drops since the last one, straight to
+// the file since the ring may still be full
+static void flush_dropped() {
+  uint64_t total = atomic_load_explicit(&dropped, memory_order_relaxed);
+  if (total == reported) {
+    return;
+  }
+  trace_record rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.ns = now_ns();
+  rec.tick = ticks;
+  rec.type = TRACE_DROPPED;
+  rec.arg = (int32_t)(total - reported);
+  if (write_all(&rec, sizeof(rec))) {
+    reported = total;
+  }
+}
+
+static void flush_pending() {
+  trace_record batch[FLUSH_BATCH];
+  int count;
+  while ((count = ring_drain(batch)) > 0) {
+    if (!write_all(batch, count * sizeof(trace_record))) {
+      return;
+    }
+  }
+  flush_dropped();
+}
+
+static void* flusher_main(void* arg) {
+  struct timespec interval = {.tv_sec = 0, .tv_nsec = FLUSH_INTERVAL_NS};
+  while (!atomic_load_explicit(&flusher_stop, memory_order_acquire)) {
+    flush_pending();
+    nanosleep(&interval, NULL);
+  }
+  flush_pending();
+  return NULL;
+}
+
+int k_trace_init(int fd) {
+  pthread_once(&ring_once, ring_init);
+  trace_fd = fd;
+
+  trace_file_header header;
+  memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+  header.version = TRACE_VERSION;
+  header.record_size = sizeof(trace_record);
+  if (write(fd, &header, sizeof(header)) != sizeof(header)) {
+    return -1;
+  }
+
+  // The flusher must never take SIGALRM (the scheduler's clock) or any of the
+  // terminal signals meant for PennOS, so it starts with everything blocked.
+  sigset_t all, old;
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+  int res = pthread_create(&flusher, NULL, flusher_main, NULL);
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+  if (res != 0) {
+    return -1;
+  }
+  atomic_store_explicit(&flusher_running, true, memory_order_release);
+  return 0;
+}
+
+void k_trace_shutdown() {
+  if (!atomic_load_explicit(&flusher_running, memory_order_acquire)) {
+    return;
+  }
+  atomic_store_explicit(&flusher_stop, true, memory_order_release);
+  pthread_join(flusher, NULL);
+  atomic_store_explicit(&flusher_running, false, memory_order_release);
+}
+
+void k_trace_event_ext(int type, pcb* proc, int priority, int arg) {
+  trace_record rec;
+  rec.ns = now_ns();
+  rec.tick = ticks;
+  rec.pid = proc->pid;
+  rec.type = (int16_t)type;
+  rec.priority = (int16_t)priority;
+  rec.arg = arg;
+  strncpy(rec.name, proc->process_name, TRACE_NAME_SIZE);
+  ring_push(&rec);
+}
+
+void k_trace_event(int type, pcb* proc) {
+  k_trace_event_ext(type, proc, proc->priority, 0);
+}
+
+void k_trace_runqueue(int priority, int depth) {
+  trace_record rec;
+  rec.ns = now_ns();
+  rec.tick = ticks;
+  rec.pid = 0;
+  rec.type = TRACE_RUNQUEUE;
+  rec.priority = (int16_t)priority;
+  rec.arg = depth;
+  memset(rec.name, 0, TRACE_NAME_SIZE);
+  ring_push(&rec);
+}
+
+void k_trace_text(const char* message) {
+  size_t len = strlen(message);
+  uint64_t ns = now_ns();
+  for (size_t off = 0; off < len; off += TRACE_NAME_SIZE) {
+    trace_record rec;
+    size_t n = len - off < TRACE_NAME_SIZE ? len - off : TRACE_NAME_SIZE;
+    rec.ns = ns;
+    rec.tick = ticks;
+    rec.pid = 0;
+    rec.type = TRACE_TEXT;
+    rec.priority = 0;
+    rec.arg = (int32_t)n;
+    memset(rec.name, 0, TRACE_NAME_SIZE);
+    memcpy(rec.name, message + off, n);
+    ring_push(&rec);
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "../util/PCB.h"
+#include "../util/trace_record.h"
+
+// Number of records the in-memory ring can hold (must be a power of two)
+#define TRACE_RING_SIZE 16384
+
+/**
+ * @brief Writes the trace header to fd and starts the background thread which
+ * flushes the ring to it.
+ *
+ * @param fd host file descriptor of the log file
+ * @return 0 on success, -1 on error
+ */
+int k_trace_init(int fd);
+
+/**
+ * @brief Stops the flusher thread and writes out any records still buffered.
+ */
+void k_trace_shutdown(void);
+
+/**
+ * @brief Records an event about a process, using its current priority.
+ *
+ * @param type one of the TRACE_* event types
+ * @param proc the process the event is about
+ */
+void k_trace_event(int type, pcb* proc);
+
+/**
+ * @brief Records an event with an explicit priority and extra argument.
+ *
+ * @param type one of the TRACE_* event types
+ * @param proc the process the event is about
+ * @param priority priority to record
+ * @param arg event specific argument (new priority for TRACE_NICE)
+ */
+void k_trace_event_ext(int type, pcb* proc, int priority, int arg);
+
+/**
+ * @brief Records the number of jobs waiting in the queue for a priority level.
+ *
+ * @param priority the priority level
+ * @param depth number of runnable jobs queued at that level
+ */
+void k_trace_runqueue(int priority, int depth);
+
+/**
+ * @brief Records a free-form text message, split across as many records as
+ * needed.
+ *
+ * @param message null-terminated message
+ */
+void k_trace_text(const char* message);
+
+#endif
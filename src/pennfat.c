@@ -36,12 +36,12 @@ pid_t fgJob = 0;
 bool logged_out = false;
 pid_t plus_pid = -1;
 pid_t currentJob = 0;
-int num_bg_jobs = 0;
 int P_ERRNO = 0;
 
 // Declared as global variable across files
 PCBDeque* PCBList;
-PIDDeque* priorityList[4];  // 0 -> priority_zero, ... 3 -> inactive
+// 0 -> priority_zero, ..., INACTIVE_QUEUE -> inactive
+PIDDeque* priorityList[MAX_PRIORITY_LEVELS + 1];
 pid_t pidCount = 0;         // global variable which assigns PID to new process,
                             // incremented by one each time
 
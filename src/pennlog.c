@@ -0,0 +1,344 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE 1
+#endif
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "util/macros.h"
+#include "util/trace_record.h"
+
+#define DEFAULT_LOG "./log/log"
+#define READ_BATCH 256
+
+/**
+ * @brief Reads exactly n bytes unless end of file is reached first
+ *
+ * @return number of bytes read, -1 on error
+ */
+static ssize_t read_full(int fd, void* buf, size_t n) {
+  size_t total = 0;
+  while (total < n) {
+    ssize_t res = read(fd, (char*)buf + total, n - total);
+    if (res == -1) {
+      return -1;
+    }
+    if (res == 0) {
+      break;
+    }
+    total += res;
+  }
+  return total;
+}
+
+// Per-PID state while converting to the Chrome trace-event format. Start
+// times are 0 when the corresponding interval is not open.
+typedef struct pid_track {
+  uint64_t run_start;
+  uint64_t blocked_start;
+  uint64_t stopped_start;
+  int priority;
+  bool named;
+} pid_track;
+
+typedef struct chrome_state {
+  pid_track* tracks;
+  int num_tracks;
+  int running;  // pid currently holding the CPU, -1 if none
+  int depth[MAX_PRIORITY_LEVELS];
+  int num_levels;  // levels in the counter, 3 unless a deeper one was seen
+  uint64_t base_ns;
+  bool first_event;
+} chrome_state;
+
+static pid_track* track_for(chrome_state* st, int pid) {
+  if (pid < 0) {
+    return NULL;
+  }
+  if (pid >= st->num_tracks) {
+    int new_size = st->num_tracks == 0 ? 64 : st->num_tracks;
+    while (new_size <= pid) {
+      new_size *= 2;
+    }
+    st->tracks = realloc(st->tracks, new_size * sizeof(pid_track));
+    memset(st->tracks + st->num_tracks, 0,
+           (new_size - st->num_tracks) * sizeof(pid_track));
+    st->num_tracks = new_size;
+  }
+  return &st->tracks[pid];
+}
+
+static double to_us(chrome_state* st, uint64_t ns) {
+  return (double)(ns - st->base_ns) / 1000.0;
+}
+
+static void emit_sep(chrome_state* st) {
+  printf(st->first_event ? "\n" : ",\n");
+  st->first_event = false;
+}
+
+// Emits a complete ("X") slice on the track of pid
+static void emit_slice(chrome_state* st,
+                       int pid,
+                       const char* name,
+                       uint64_t start,
+                       uint64_t end,
+                       int priority) {
+  emit_sep(st);
+  printf(
+      "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+      "\"dur\":%.3f,\"pid\":0,\"tid\":%d,\"args\":{\"priority\":%d}}",
+      name, name, to_us(st, start), (double)(end - start) / 1000.0, pid,
+      priority);
+}
+
+// Emits an instant ("i") event on the track of the record's pid
+static void emit_instant(chrome_state* st, const trace_record* rec) {
+  char label[16];
+  snprintf(label, sizeof(label), "%s", trace_label(rec->type));
+  // strip the padding used by the text log
+  for (int i = strlen(label) - 1; i >= 0 && label[i] == ' '; i--) {
+    label[i] = '\0';
+  }
+  emit_sep(st);
+  printf(
+      "{\"name\":\"%s\",\"cat\":\"event\",\"ph\":\"i\",\"s\":\"t\","
+      "\"ts\":%.3f,\"pid\":0,\"tid\":%d,\"args\":{\"priority\":%d,"
+      "\"arg\":%d}}",
+      label, to_us(st, rec->ns), rec->pid, rec->priority, rec->arg);
+}
+
+static void emit_thread_name(chrome_state* st, const trace_record* rec) {
+  char name[TRACE_NAME_SIZE + 1];
+  memcpy(name, rec->name, TRACE_NAME_SIZE);
+  name[TRACE_NAME_SIZE] = '\0';
+  // keep the JSON string valid whatever the process was called
+  for (char* c = name; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\' || (unsigned char)*c < 0x20) {
+      *c = '_';
+    }
+  }
+  emit_sep(st);
+  printf(
+      "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+      "\"args\":{\"name\":\"%d %s\"}}",
+      rec->pid, rec->pid, name);
+  emit_sep(st);
+  printf(
+      "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,"
+      "\"tid\":%d,\"args\":{\"sort_index\":%d}}",
+      rec->pid, rec->pid);
+}
+
+// Closes the run slice of the job holding the CPU, if any
+static void stop_running(chrome_state* st, uint64_t ns) {
+  pid_track* track = track_for(st, st->running);
+  if (track != NULL && track->run_start != 0) {
+    emit_slice(st, st->running, "run", track->run_start, ns, track->priority);
+    track->run_start = 0;
+  }
+  st->running = -1;
+}
+
+static void end_blocked(chrome_state* st, int pid, uint64_t ns) {
+  pid_track* track = track_for(st, pid);
+  if (track->blocked_start != 0) {
+    emit_slice(st, pid, "blocked", track->blocked_start, ns, track->priority);
+    track->blocked_start = 0;
+  }
+}
+
+static void end_stopped(chrome_state* st, int pid, uint64_t ns) {
+  pid_track* track = track_for(st, pid);
+  if (track->stopped_start != 0) {
+    emit_slice(st, pid, "stopped", track->stopped_start, ns, track->priority);
+    track->stopped_start = 0;
+  }
+}
+
+static void chrome_record(chrome_state* st, const trace_record* rec) {
+  if (rec->type == TRACE_TEXT) {
+    return;
+  }
+  if (st->base_ns == 0) {
+    st->base_ns = rec->ns;
+  }
+  if (rec->type == TRACE_DROPPED) {
+    emit_sep(st);
+    printf(
+        "{\"name\":\"dropped\",\"cat\":\"trace\",\"ph\":\"i\","
+        "\"s\":\"g\",\"ts\":%.3f,\"pid\":0,\"args\":{\"records\":%d}}",
+        to_us(st, rec->ns), rec->arg);
+    return;
+  }
+  if (rec->type == TRACE_RUNQUEUE) {
+    if (rec->priority < 0 || rec->priority >= MAX_PRIORITY_LEVELS) {
+      return;
+    }
+    st->depth[rec->priority] = rec->arg;
+    if (rec->priority >= st->num_levels) {
+      st->num_levels = rec->priority + 1;
+    }
+    emit_sep(st);
+    printf(
+        "{\"name\":\"runnable\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":0,"
+        "\"args\":{",
+        to_us(st, rec->ns));
+    for (int i = 0; i < st->num_levels; i++) {
+      printf("%s\"p%d\":%d", i == 0 ? "" : ",", i, st->depth[i]);
+    }
+    printf("}}");
+    return;
+  }
+
+  pid_track* track = track_for(st, rec->pid);
+  if (track == NULL) {
+    return;
+  }
+  if (!track->named) {
+    emit_thread_name(st, rec);
+    track->named = true;
+  }
+
+  switch (rec->type) {
+    case TRACE_SCHEDULE:
+      stop_running(st, rec->ns);
+      end_blocked(st, rec->pid, rec->ns);
+      track->run_start = rec->ns;
+      track->priority = rec->priority;
+      st->running = rec->pid;
+      return;
+    case TRACE_BLOCKED:
+      if (st->running == rec->pid) {
+        stop_running(st, rec->ns);
+      }
+      track->blocked_start = rec->ns;
+      track->priority = rec->priority;
+      return;
+    case TRACE_UNBLOCKED:
+      end_blocked(st, rec->pid, rec->ns);
+      return;
+    case TRACE_STOPPED:
+      if (st->running == rec->pid) {
+        stop_running(st, rec->ns);
+      }
+      end_blocked(st, rec->pid, rec->ns);
+      track->stopped_start = rec->ns;
+      break;
+    case TRACE_CONTINUED:
+      end_stopped(st, rec->pid, rec->ns);
+      break;
+    case TRACE_EXITED:
+    case TRACE_SIGNALED:
+      if (st->running == rec->pid) {
+        stop_running(st, rec->ns);
+      }
+      end_blocked(st, rec->pid, rec->ns);
+      end_stopped(st, rec->pid, rec->ns);
+      break;
+    case TRACE_NICE:
+      track->priority = rec->arg;
+      break;
+    default:
+      break;
+  }
+  emit_instant(st, rec);
+}
+
+/**
+ * @brief Decodes a binary PennOS log back into the text log format, or with
+ * -c into Chrome trace-event JSON (loadable in chrome://tracing or Perfetto)
+ * with one track per PID.
+ *
+ * Example Usage: ./bin/pennlog log/log
+ * Example Usage: ./bin/pennlog -c log/log > trace.json
+ */
+int main(int argc, char* argv[]) {
+  bool chrome = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "c")) != -1) {
+    if (opt == 'c') {
+      chrome = true;
+    } else {
+      fprintf(stderr, "usage: %s [-c] [logfile]\n", argv[0]);
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (argc - optind > 1) {
+    fprintf(stderr, "usage: %s [-c] [logfile]\n", argv[0]);
+    exit(EXIT_FAILURE);
+  }
+  const char* log_file = optind < argc ? argv[optind] : DEFAULT_LOG;
+
+  int fd = open(log_file, O_RDONLY);
+  if (fd == -1) {
+    perror("pennlog: open");
+    exit(EXIT_FAILURE);
+  }
+
+  trace_file_header header;
+  if (read_full(fd, &header, sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0) {
+    fprintf(stderr, "pennlog: %s is not a PennOS trace\n", log_file);
+    close(fd);
+    exit(EXIT_FAILURE);
+  }
+  if (header.version != TRACE_VERSION ||
+      header.record_size != sizeof(trace_record)) {
+    fprintf(stderr, "pennlog: unsupported trace version %u\n", header.version);
+    close(fd);
+    exit(EXIT_FAILURE);
+  }
+
+  chrome_state st = {.running = -1, .num_levels = 3, .first_event = true};
+  if (chrome) {
+    printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  }
+
+  trace_record batch[READ_BATCH];
+  ssize_t bytes;
+  uint64_t last_ns = 0;
+  long dropped = 0;
+  while ((bytes = read_full(fd, batch, sizeof(batch))) > 0) {
+    size_t count = bytes / sizeof(trace_record);
+    for (size_t i = 0; i < count; i++) {
+      if (batch[i].type == TRACE_DROPPED) {
+        dropped += batch[i].arg;
+      }
+      if (chrome) {
+        chrome_record(&st, &batch[i]);
+        last_ns = batch[i].ns;
+        continue;
+      }
+      char line[128];
+      int len = trace_format(&batch[i], line, sizeof(line));
+      fwrite(line, 1, len, stdout);
+    }
+  }
+
+  if (chrome) {
+    // close intervals still open when the log ended
+    stop_running(&st, last_ns);
+    for (int pid = 0; pid < st.num_tracks; pid++) {
+      end_blocked(&st, pid, last_ns);
+      end_stopped(&st, pid, last_ns);
+    }
+    printf("\n]}\n");
+    free(st.tracks);
+  }
+
+  if (dropped > 0) {
+    fprintf(stderr, "pennlog: %ld records were dropped from a full ring\n",
+            dropped);
+  }
+  close(fd);
+  return bytes == -1 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
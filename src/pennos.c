@@ -1,16 +1,30 @@
 #include <fcntl.h>
 #include <pthread.h>
 #include <signal.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "util/spthread.h"
 
+#include "kernel/aging.h"
+#include "kernel/aio.h"
+#include "kernel/cgroup.h"
+#include "kernel/edf.h"
+#include "kernel/fdpoll.h"
+#include "kernel/job_control.h"
 #include "kernel/kernel.h"
 #include "kernel/kernel_system.h"
+#include "kernel/pidmap.h"
+#include "kernel/runqueue.h"
+#include "kernel/schedstat.h"
+#include "kernel/signal_queue.h"
+#include "kernel/trace.h"
 #include "kernel/shell.h"
 #include "util/PCBDeque.h"
 #include "util/PIDDeque.h"
@@ -34,7 +48,8 @@
 
 // Declared as global variable across files
 PCBDeque* PCBList;
-PIDDeque* priorityList[4];  // 0 -> priority_zero, ... 3 -> inactive
+// 0 -> priority_zero, ..., INACTIVE_QUEUE -> inactive
+PIDDeque* priorityList[MAX_PRIORITY_LEVELS + 1];
 
 pid_t pidCount = 0;  // global variable which assigns PID to new process,
                      // incremented by one each time
@@ -50,7 +65,6 @@ uint16_t* fat = NULL;    // FAT
 global_fdt g_fdt[1024];  // Global File Descriptor Table
 int g_counter = 0;
 bool logged_out = false;
-int num_bg_jobs = 0;
 pid_t plus_pid = -1;
 int P_ERRNO = 0;
 TerminalHistory* curr_history;
@@ -61,119 +75,75 @@ TerminalHistory* curr_history;
 
 const int QUANTUM = 100;
 
+#ifndef PENNOS_SIM
+#define HOST_SIGINT 1u
+#define HOST_SIGTSTP 2u
+
+// Host signals received but not yet handled. The handler may interrupt the
+// scheduler in the middle of updating a list, so it only sets a bit here and
+// the scheduler acts on it at the start of the next tick.
+static atomic_uint host_signals;
+
 static void signal_handler(int signum) {
-  if (signum == SIGINT) {
-    if (s_write(STDERR_FILENO, "\n", 1) == -1) {
-      s_exit();
-    }
-    if (fgJob == 1 && (s_write(STDERR_FILENO, PROMPT, PROMPT_SIZE) == -1)) {
-      s_exit();
-    }
-    if (fgJob > 1) {
-      s_kill(fgJob, P_SIGTERM);
-    }
-  } else if (signum == SIGTSTP) {
-    if (s_write(STDERR_FILENO, "\n", 1) == -1) {
-      s_exit();
-    }
-    if (fgJob == 1 && (s_write(STDERR_FILENO, PROMPT, PROMPT_SIZE) == -1)) {
-      s_exit();
-    }
-    if (fgJob > 1) {
-      s_kill(fgJob, P_SIGSTOP);
+  atomic_fetch_or(&host_signals,
+                  signum == SIGINT ? HOST_SIGINT : HOST_SIGTSTP);
+}
+
+// Posts a signal to the foreground job's whole process group, falling back to
+// just the foreground process if it shares the shell's group
+static void signal_foreground(int signal) {
+  if (s_write(STDERR_FILENO, "\n", 1) == -1) {
+    s_exit();
+  }
+  if (fgJob == 1 && (s_write(STDERR_FILENO, PROMPT, PROMPT_SIZE) == -1)) {
+    s_exit();
+  }
+  if (fgJob > 1) {
+    pid_t pgid = k_getpgid(fgJob);
+    if (pgid > 1) {
+      k_post_signal_group(pgid, signal);
+    } else {
+      k_post_signal(fgJob, signal);
     }
   }
 }
 
-static void updateplus_pid() {
-  pcb* curr_job = NULL;
-  curr_job = PCBDequeStopSearch(PCBList);
-  if (curr_job == NULL) {
-    curr_job = PCBDequeBackgroundSearch(PCBList);
+static void drain_host_signals() {
+  unsigned int pending = atomic_exchange(&host_signals, 0);
+  if (pending & HOST_SIGINT) {
+    signal_foreground(P_SIGTERM);
   }
-  if (curr_job == NULL || curr_job->status == STATUS_FINISHED ||
-      curr_job->status == STATUS_TERMINATED) {
-  } else {
-    plus_pid = curr_job->pid;
+  if (pending & HOST_SIGTSTP) {
+    signal_foreground(P_SIGSTOP);
   }
 }
+#endif
+
 // signal handler for sigalarm
 // can be left empty since we just need
 // to know that the handler has gone off and not
 // terminate when we get the signal.
+#ifndef PENNOS_SIM
 static void alarm_handler(int signum) {}
+#endif
 
-static int select_job() {
-  // The 1.5 ratios between priority levels are expected values
-  // That means we just need to sample from a 9:6:4 distribution
-  // In expectation, that will achieve the desired ratio
-
-  // See which of the priority levels have an unfinished job
-  int size0 = PIDDeque_Size(priorityList[0]);
-  int size1 = PIDDeque_Size(priorityList[1]);
-  int size2 = PIDDeque_Size(priorityList[2]);
-
-  // Nothing in any queue
-  if (size0 + size1 + size2 == 0) {
-    // Something wrong -- there should always be a thread to run
-    return -1;
-  }
-  // Only a job in priority 0
-  else if ((size0) > 0 && (size1 + size2 == 0)) {
-    return 0;
-  }
-  // Only a job in priority 1
-  else if ((size1) > 0 && (size0 + size2 == 0)) {
-    return 1;
-  }
-  // Only a job in priority 2
-  else if ((size2) > 0 && (size0 + size1 == 0)) {
-    return 2;
-  }
-  // Jobs in priority 0 and 1
-  else if ((size0 > 0) && (size1 > 0) && (size2 == 0)) {
-    int random = rand() % 5;
-    if (random <= 2) {
-      return 0;
-    } else {
-      return 1;
-    }
-  }
-  // Jobs in priority 1 and 2
-  else if ((size1 > 0) && (size2 > 0) && (size0 == 0)) {
-    int random = rand() % 5;
-    if (random <= 2) {
-      return 1;
-    } else {
-      return 2;
-    }
-  }
-  // Jobs in priority 0 and 2
-  else if ((size0 > 0) && (size2 > 0) && (size1 == 0)) {
-    int random = rand() % 13;
-    if (random <= 8) {
-      return 0;
-    } else {
-      return 2;
-    }
-  }
-  // Jobs in all priorities
-  else {
-    int random = rand() % 19;
-    if (random <= 8) {
-      return 0;
-    } else if (random <= 14) {
-      return 1;
-    } else {
-      return 2;
+// Logs the depth of each runnable queue whenever it differs from the last tick,
+// so trace viewers can plot queue lengths over time
+static void trace_queue_depths() {
+  // depth + 1 of each queue when last logged, 0 until the first tick
+  static int last_logged[MAX_PRIORITY_LEVELS];
+  for (int i = 0; i < k_num_levels(); i++) {
+    int depth = k_runqueue_depth(i);
+    if (depth + 1 != last_logged[i]) {
+      k_trace_runqueue(i, depth);
+      last_logged[i] = depth + 1;
     }
   }
 }
 
 static void add_job_back(pcb* this_pcb) {
   if (P_WIFRUNNING(this_pcb->status)) {
-    int priority = this_pcb->priority;
-    PIDDeque_Push_Back(priorityList[priority], this_pcb->pid);
+    k_enqueue_runnable(this_pcb);
   } else if (P_WIFBLOCKED(this_pcb->status)) {
     // If blocked, waitPID or sleep will already have added the parent to
     // inactive
@@ -184,6 +154,53 @@ static void add_job_back(pcb* this_pcb) {
   }
 }
 
+// Advances the clock by one tick, wakes sleepers and removes the next job to
+// run from its queue, making it the current job. Returns NULL with idle set if
+// nothing is runnable, or NULL alone if the chosen pid no longer exists.
+static pcb* next_job(bool* idle) {
+  ticks++;  // Increment the number of ticks
+#ifndef PENNOS_SIM
+  drain_host_signals();
+#endif
+  k_deliver_signals();
+  k_sleep_check();
+  k_poll_tick();
+  k_aio_tick();
+  k_edf_tick();
+  k_cgroup_tick();
+  k_age_runnable();
+  trace_queue_depths();
+  // Real-time jobs first, then a CPU group by shares, then within it the
+  // lottery over the non-empty levels (weighted 9:6:4 by default), or the
+  // least vruntime under cfs
+  pid_t threadPID = k_runqueue_next();
+
+  if (threadPID == -1) {
+    *idle = true;
+    return NULL;
+  }
+
+  pcb* this_pcb = PCBDequeJobSearch(PCBList, threadPID);
+  if (this_pcb == NULL) {
+    return NULL;
+  }
+  // latency is charged to the job's own priority even if aging raised it
+  k_schedstat_dispatch(this_pcb, this_pcb->priority);
+  int choice = k_run_level(this_pcb);
+  this_pcb->boost = 0;
+  if (threadPID != currentJob) {
+    k_trace_event_ext(TRACE_SCHEDULE, this_pcb, choice, 0);
+  }
+
+  currentJob = threadPID;
+  if (!this_pcb->is_background) {
+    fgJob = threadPID;
+  }
+  return this_pcb;
+}
+
+#ifndef PENNOS_SIM
+
 static void scheduler(void) {
   // The scheduler should not stop for any signal other than SIGALRM
   sigset_t suspend_set;
@@ -210,38 +227,16 @@ static void scheduler(void) {
   setitimer(ITIMER_REAL, &it, NULL);
 
   // Looks to check the global value done
-  int choice = 0;
   while (true) {
-    ticks++;  // Increment the number of ticks
-    k_sleep_check();
-    updateplus_pid();
-    choice = select_job();
-
-    if (choice == -1) {
+    bool idle = false;
+    pcb* this_pcb = next_job(&idle);
+    if (idle) {
       sigsuspend(&suspend_set);
       continue;
     }
-
-    PIDDeque* this_deque = priorityList[choice];
-    pid_t threadPID = -1;
-    PIDDeque_Peek_Front(this_deque, &threadPID);
-    PIDDeque_Pop_Front(this_deque);
-
-    pcb* this_pcb = PCBDequeJobSearch(PCBList, threadPID);
     if (this_pcb == NULL) {
       continue;
     }
-    if (threadPID != currentJob) {
-      char message[100];
-      sprintf(message, "[%3d]\tSCHEDULE \t%d\t%d\t%-15s\n", ticks,
-              this_pcb->pid, choice, this_pcb->process_name);
-      s_log(message);
-    }
-
-    currentJob = threadPID;
-    if (!this_pcb->is_background) {
-      fgJob = threadPID;
-    }
 
     spthread_t this_thread = this_pcb->curr_thread;
     spthread_continue(this_thread);
@@ -250,10 +245,9 @@ static void scheduler(void) {
     add_job_back(this_pcb);
 
     if (logged_out) {
-      PCBDeque_Free(PCBList);
-      for (int i = 0; i < 4; i++) {
-        PIDDeque_Free(priorityList[i]);
-      }
+      k_schedstat_dump();
+      k_trace_shutdown();
+      k_free_lists();
       free_history(curr_history);
       exit(EXIT_SUCCESS);
     }
@@ -261,6 +255,22 @@ static void scheduler(void) {
 }
 
 int main(int argc, char* argv[]) {
+  int opt;
+  while ((opt = getopt(argc, argv, "p:S:m:")) != -1) {
+    if ((opt == 'p' && k_levels_parse(optarg) == -1) ||
+        (opt == 'S' && k_sched_set_policy(optarg) == -1) ||
+        (opt == 'm' && k_pid_set_max(atoi(optarg)) == -1) ||
+        (opt != 'p' && opt != 'S' && opt != 'm')) {
+      P_ERRNO = EARG;
+      u_error(
+          "usage: pennos [-p weights] [-S lottery|cfs] [-m pid_max] fatfs "
+          "[log]");
+      exit(EXIT_FAILURE);
+    }
+  }
+  argc -= optind - 1;
+  argv += optind - 1;
+
   if (argc == 2) {
     logFileName = "./log/log";
   } else if (argc == 3) {
@@ -285,6 +295,11 @@ int main(int argc, char* argv[]) {
 
   // Open logfile
   logfd = open(logFileName, O_TRUNC | O_RDWR | O_CREAT, OPEN_FLAG);
+  if (logfd == -1 || k_trace_init(logfd) == -1) {
+    P_ERRNO = EHOST;
+    u_error("Unable to open log file");
+    exit(EXIT_FAILURE);
+  }
 
   curr_history = read_history_from_file();
 
@@ -307,4 +322,653 @@ int main(int argc, char* argv[]) {
   s_nice(shellPID, 0);
 
   scheduler();
-}
\ No newline at end of file
+}
+
+#else  // PENNOS_SIM
+
+/******************************************/
+/*             SIMULATION MODE            */
+/******************************************/
+
+// Built as bin/pennos-sim (make sim). Jobs have no host threads: every tick the
+// scheduler picks a job with the same run queue / k_sleep_check code
+// and runs one step of a synthetic workload inline, so ticks advance as fast
+// as the host allows instead of every QUANTUM ms.
+
+#define SIM_DEFAULT_TICKS 10000
+#define SIM_MAX_WORKLOADS 32
+#define SIM_WINDOW 100  // ticks per window when measuring short-term fairness
+#define SIM_MAX_GROUPS 8
+
+typedef enum { SIM_CPU, SIM_IO, SIM_SHORT } sim_kind;
+
+static const char* sim_kind_names[] = {"cpu", "io", "short"};
+
+// One -w kind:count:priority[:burst] argument
+typedef struct sim_workload {
+  sim_kind kind;
+  int count;
+  int priority;
+  int burst;  // ticks of CPU before sleeping (io) or exiting (short)
+  int period;  // real-time period from -r, 0 for best-effort workloads
+  int budget;  // real-time budget per period
+  int group;   // CPU group from the last -g before it, 0 for the root
+} sim_workload;
+
+// One -g shares[:quota:period] argument
+typedef struct sim_group {
+  int shares;
+  int quota;
+  int period;
+} sim_group;
+
+// Per-pid state of a synthetic job
+typedef struct sim_job {
+  bool active;
+  int workload;  // index into workloads
+  int left;      // ticks left in the current burst
+  pid_t sleeper;  // sleep child the job is waiting on, -1 if none
+  int ran;        // ticks the job was dispatched for
+  int last_run;   // tick the job last ran (or was created / woke up)
+  int max_gap;    // longest wait between two runs while runnable
+} sim_job;
+
+static sim_workload workloads[SIM_MAX_WORKLOADS];
+static int num_workloads = 0;
+static sim_group sim_groups[SIM_MAX_GROUPS + 1] = {
+    {.shares = CGROUP_DEFAULT_SHARES, .period = CGROUP_DEFAULT_PERIOD}};
+static int num_groups = 0;  // # -g arguments
+static sim_job* sim_jobs = NULL;
+static int sim_jobs_size = 0;
+static pcb* sim_root = NULL;
+static long* sim_gaps[MAX_PRIORITY_LEVELS];  // per priority, how often each
+                                            // wait length occurred
+static double sim_target[MAX_PRIORITY_LEVELS];  // CPU share each level should
+                                                // get, 0 if it has no jobs
+static double sim_window_dev[MAX_PRIORITY_LEVELS];  // worst distance from the
+                                                    // target over any window
+
+static sim_job* sim_job_for(pid_t pid) {
+  if (pid >= sim_jobs_size) {
+    int new_size = sim_jobs_size == 0 ? 64 : sim_jobs_size;
+    while (new_size <= pid) {
+      new_size *= 2;
+    }
+    sim_jobs = realloc(sim_jobs, new_size * sizeof(sim_job));
+    memset(sim_jobs + sim_jobs_size, 0, (new_size - sim_jobs_size) * sizeof(sim_job));
+    sim_jobs_size = new_size;
+  }
+  return &sim_jobs[pid];
+}
+
+// Creates a job for workload w as a background child of the root
+static void sim_spawn(int w) {
+  spthread_t no_thread = {0};
+  pcb* proc = k_proc_create(sim_root, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                            (char*)sim_kind_names[workloads[w].kind], true,
+                            NULL);
+  if (proc == NULL) {
+    P_ERRNO = EPIDS;
+    u_error("Unable to spawn workload");
+    exit(EXIT_FAILURE);
+  }
+  k_trace_event(TRACE_CREATE, proc);
+  if (workloads[w].priority != proc->priority) {
+    k_change_priority(proc->pid, workloads[w].priority);
+  }
+  if (workloads[w].group != CGROUP_ROOT) {
+    k_cgroup_attach(proc->pid, workloads[w].group);
+  }
+  if (workloads[w].period > 0 &&
+      s_sched_setattr(proc->pid, workloads[w].period, workloads[w].budget) ==
+          -1) {
+    u_error("Real-time workload not admitted");
+    exit(EXIT_FAILURE);
+  }
+  sim_job* job = sim_job_for(proc->pid);
+  *job = (sim_job){
+      .active = true,
+      .workload = w,
+      .left = workloads[w].burst,
+      .sleeper = -1,
+      .last_run = ticks,
+  };
+}
+
+// Puts the current job to sleep the way the shell runs `sleep 1`: a
+// foreground sleep child that blocks its parent until k_sleep_check wakes it
+static void sim_sleep(pcb* proc, sim_job* job) {
+  spthread_t no_thread = {0};
+  pcb* sleeper = k_proc_create(proc, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                               "sleep", false, NULL);
+  if (sleeper == NULL) {
+    P_ERRNO = EPIDS;
+    u_error("Unable to spawn sleep");
+    exit(EXIT_FAILURE);
+  }
+  k_trace_event(TRACE_CREATE, sleeper);
+  currentJob = sleeper->pid;
+  k_sleep(1);
+  currentJob = proc->pid;
+  k_block(proc);
+  job->sleeper = sleeper->pid;
+}
+
+// Runs one quantum of the current job's workload
+static void sim_step(pcb* proc) {
+  sim_job* job = sim_job_for(proc->pid);
+  if (!job->active) {
+    return;
+  }
+  if (job->sleeper != -1) {
+    // woken up by the sleep child finishing, reap it
+    k_waitpid(job->sleeper, NULL, true);
+    job->sleeper = -1;
+    job->last_run = ticks - 1;
+  }
+
+  sim_workload* w = &workloads[job->workload];
+  int gap = ticks - job->last_run - 1;
+  if (gap > job->max_gap) {
+    job->max_gap = gap;
+  }
+  if (w->period == 0) {
+    sim_gaps[w->priority][gap]++;
+  }
+  job->last_run = ticks;
+  job->ran++;
+
+  if (w->kind == SIM_CPU || --job->left > 0) {
+    return;
+  }
+  job->left = w->burst;
+  if (w->kind == SIM_IO) {
+    sim_sleep(proc, job);
+  } else {
+    k_exit();
+  }
+}
+
+// Reaps finished short jobs on behalf of the root and replaces each with a
+// fresh job of the same workload, keeping the load constant
+static void sim_reap(int* done) {
+  pid_t saved = currentJob;
+  currentJob = sim_root->pid;
+  pid_t pid;
+  while (PIDDeque_Size(sim_root->ready_children) > 0 &&
+         (pid = k_waitpid(-1, NULL, true)) > 0) {
+    sim_job* job = sim_job_for(pid);
+    job->active = false;
+    (*done)++;
+    sim_spawn(job->workload);
+  }
+  currentJob = saved;
+}
+
+static int sim_parse_workload(char* spec) {
+  if (num_workloads == SIM_MAX_WORKLOADS) {
+    return -1;
+  }
+  char kind[16];
+  sim_workload w = {
+      .count = 1, .priority = 1, .burst = 1, .group = num_groups};
+  int n = sscanf(spec, "%15[a-z]:%d:%d:%d", kind, &w.count, &w.priority,
+                 &w.burst);
+  if (n < 1 || w.count < 0 || w.priority < 0 ||
+      w.priority >= MAX_PRIORITY_LEVELS || w.burst < 1) {
+    return -1;
+  }
+  if (strcmp(kind, "cpu") == 0) {
+    w.kind = SIM_CPU;
+  } else if (strcmp(kind, "io") == 0) {
+    w.kind = SIM_IO;
+  } else if (strcmp(kind, "short") == 0) {
+    w.kind = SIM_SHORT;
+  } else {
+    return -1;
+  }
+  workloads[num_workloads++] = w;
+  return 0;
+}
+
+// Parses -r period:budget[:count], count always-runnable real-time jobs
+static int sim_parse_realtime(char* spec) {
+  if (num_workloads == SIM_MAX_WORKLOADS) {
+    return -1;
+  }
+  sim_workload w = {.kind = SIM_CPU, .count = 1, .priority = 1, .burst = 1};
+  int n = sscanf(spec, "%d:%d:%d", &w.period, &w.budget, &w.count);
+  if (n < 2 || w.period <= 0 || w.budget <= 0 || w.budget > w.period ||
+      w.count < 0) {
+    return -1;
+  }
+  workloads[num_workloads++] = w;
+  return 0;
+}
+
+// Parses -g shares[:quota:period], a CPU group under the root for the
+// workloads that follow it
+static int sim_parse_group(char* spec) {
+  if (num_groups == SIM_MAX_GROUPS) {
+    return -1;
+  }
+  sim_group g = {.period = CGROUP_DEFAULT_PERIOD};
+  int n = sscanf(spec, "%d:%d:%d", &g.shares, &g.quota, &g.period);
+  if (n < 1 || n == 2 || g.shares <= 0 || g.shares > CGROUP_MAX_SHARES ||
+      g.period <= 0 || g.quota < 0 || g.quota > g.period) {
+    return -1;
+  }
+  sim_groups[++num_groups] = g;
+  return 0;
+}
+
+// Creates the -g groups, which get ids 1, 2, ... in order
+static void sim_create_groups() {
+  for (int i = 1; i <= num_groups; i++) {
+    char name[CGROUP_NAME_MAX];
+    snprintf(name, sizeof(name), "g%d", i);
+    int id = k_cgroup_create(name, CGROUP_ROOT);
+    k_cgroup_set(id, sim_groups[i].shares, sim_groups[i].quota,
+                 sim_groups[i].period);
+  }
+}
+
+static uint64_t sim_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Smallest wait that at least 99% of the dispatches at a priority did not
+// exceed
+static int sim_p99_wait(int priority, int num_ticks) {
+  long total = 0;
+  for (int gap = 0; gap <= num_ticks; gap++) {
+    total += sim_gaps[priority][gap];
+  }
+  long seen = 0;
+  for (int gap = 0; gap <= num_ticks; gap++) {
+    seen += sim_gaps[priority][gap];
+    if (seen * 100 >= total * 99) {
+      return gap;
+    }
+  }
+  return 0;
+}
+
+// Splits the CPU between the levels that have jobs in proportion to their
+// weights. The lottery weighs each level once however many jobs it has, while
+// cfs weighs every job.
+static void sim_compute_targets() {
+  long total_weight = 0;
+  long level_weight[MAX_PRIORITY_LEVELS] = {0};
+  for (int w = 0; w < num_workloads; w++) {
+    int priority = workloads[w].priority;
+    if (workloads[w].period > 0) {
+      continue;
+    } else if (k_sched_policy() == SCHED_CFS) {
+      level_weight[priority] +=
+          (long)workloads[w].count * k_level_weight(priority);
+    } else if (workloads[w].count > 0 && level_weight[priority] == 0) {
+      level_weight[priority] = k_level_weight(priority);
+    }
+  }
+  for (int i = 0; i < k_num_levels(); i++) {
+    total_weight += level_weight[i];
+  }
+  for (int i = 0; i < k_num_levels(); i++) {
+    sim_target[i] =
+        total_weight > 0 ? (double)level_weight[i] / total_weight : 0.0;
+  }
+}
+
+// Records how far each level's share of the busy ticks in the window that
+// just ended was from its target, and starts a new window
+static void sim_close_window(long* window_ticks) {
+  long busy = 0;
+  for (int i = 0; i < k_num_levels(); i++) {
+    busy += window_ticks[i];
+  }
+  for (int i = 0; i < k_num_levels(); i++) {
+    if (busy > 0 && sim_target[i] > 0) {
+      double dev = (double)window_ticks[i] / busy - sim_target[i];
+      dev = dev < 0 ? -dev : dev;
+      if (dev > sim_window_dev[i]) {
+        sim_window_dev[i] = dev;
+      }
+    }
+    window_ticks[i] = 0;
+  }
+}
+
+// Writes the ticks and deadline misses of each -r workload, against the
+// ticks its budget entitles it to
+static void sim_report_realtime(int num_ticks) {
+  printf(",\"realtime\":[");
+  bool first = true;
+  for (int w = 0; w < num_workloads; w++) {
+    if (workloads[w].period == 0) {
+      continue;
+    }
+    int jobs = 0;
+    long ran = 0;
+    long misses = 0;
+    for (int pid = 0; pid < sim_jobs_size; pid++) {
+      sim_job* job = &sim_jobs[pid];
+      pcb* proc = PCBDequeJobSearch(PCBList, pid);
+      if (job->active && job->workload == w && proc != NULL) {
+        jobs++;
+        ran += job->ran;
+        misses += proc->rt_misses;
+      }
+    }
+    long entitled =
+        (long)jobs * workloads[w].budget * (num_ticks / workloads[w].period);
+    printf(
+        "%s{\"period\":%d,\"budget\":%d,\"jobs\":%d,\"ticks\":%ld,"
+        "\"entitled\":%ld,\"misses\":%ld}",
+        first ? "" : ",", workloads[w].period, workloads[w].budget, jobs, ran,
+        entitled, misses);
+    first = false;
+  }
+  printf("]");
+}
+
+// Writes the best-effort ticks each CPU group got, the root included
+static void sim_report_groups(const long* group_ticks, long busy) {
+  printf(",\"groups\":[");
+  for (int g = 0; g <= num_groups; g++) {
+    int jobs = 0;
+    for (int w = 0; w < num_workloads; w++) {
+      if (workloads[w].group == g && workloads[w].period == 0) {
+        jobs += workloads[w].count;
+      }
+    }
+    printf(
+        "%s{\"group\":%d,\"shares\":%d,\"quota\":%d,\"period\":%d,"
+        "\"jobs\":%d,\"ticks\":%ld,\"share\":%.4f}",
+        g == 0 ? "" : ",", g, sim_groups[g].shares, sim_groups[g].quota,
+        sim_groups[g].period, jobs, group_ticks[g],
+        busy > 0 ? (double)group_ticks[g] / busy : 0.0);
+  }
+  printf("]");
+}
+
+// Writes the results as a single JSON object on stdout. Per-job details are
+// only included when verbose, since runs can have thousands of jobs.
+static void sim_report(int num_ticks,
+                       unsigned int seed,
+                       uint64_t elapsed_ns,
+                       int idle,
+                       int stale,
+                       int done,
+                       const long* level_ticks,
+                       const long* group_ticks,
+                       bool verbose) {
+  // Starvation summary per level over the jobs alive at the end
+  int level_jobs[MAX_PRIORITY_LEVELS] = {0};
+  int level_max_wait[MAX_PRIORITY_LEVELS] = {0};
+  for (int pid = 0; pid < sim_jobs_size; pid++) {
+    sim_job* job = &sim_jobs[pid];
+    if (!job->active) {
+      continue;
+    }
+    if (workloads[job->workload].period > 0) {
+      continue;
+    }
+    int priority = workloads[job->workload].priority;
+    level_jobs[priority]++;
+    if (job->max_gap > level_max_wait[priority]) {
+      level_max_wait[priority] = job->max_gap;
+    }
+  }
+  // shares are of the ticks left over by real-time jobs
+  long busy = 0;
+  for (int i = 0; i < k_num_levels(); i++) {
+    busy += level_ticks[i];
+  }
+
+  printf("{\"policy\":\"%s\",\"ticks\":%d,\"seed\":%u,",
+         k_sched_policy() == SCHED_CFS ? "cfs" : "lottery", num_ticks, seed);
+  printf("\"elapsed_ns\":%llu,", (unsigned long long)elapsed_ns);
+  printf("\"ns_per_tick\":%.1f,\"idle_ticks\":%d,\"stale_ticks\":%d,",
+         (double)elapsed_ns / num_ticks, idle, stale);
+  printf("\"short_jobs_done\":%d,", done);
+  printf("\"levels\":[");
+  for (int i = 0; i < k_num_levels(); i++) {
+    double share = busy > 0 ? (double)level_ticks[i] / busy : 0.0;
+    printf(
+        "%s{\"priority\":%d,\"jobs\":%d,\"ticks\":%ld,\"share\":%.4f,"
+        "\"target\":%.4f,\"window_dev\":%.4f,\"p99_wait\":%d,"
+        "\"max_wait\":%d}",
+        i == 0 ? "" : ",", i, level_jobs[i], level_ticks[i], share,
+        sim_target[i], sim_window_dev[i], sim_p99_wait(i, num_ticks),
+        level_max_wait[i]);
+  }
+  printf("]");
+  sim_report_realtime(num_ticks);
+  if (num_groups > 0) {
+    sim_report_groups(group_ticks, busy);
+  }
+  if (verbose) {
+    printf(",\"jobs\":[");
+    bool first = true;
+    for (int pid = 0; pid < sim_jobs_size; pid++) {
+      sim_job* job = &sim_jobs[pid];
+      if (!job->active) {
+        continue;
+      }
+      sim_workload* w = &workloads[job->workload];
+      printf(
+          "%s{\"pid\":%d,\"kind\":\"%s\",\"priority\":%d,\"ticks\":%d,"
+          "\"max_wait\":%d}",
+          first ? "" : ",", pid, sim_kind_names[w->kind], w->priority,
+          job->ran, job->max_gap);
+      first = false;
+    }
+    printf("]");
+  }
+  printf("}\n");
+}
+
+/**
+ * @brief Runs the scheduler in virtual time against synthetic workloads and
+ * prints the CPU share each priority level achieved against its target, 9:6:4
+ * unless -p gives other weights.
+ *
+ * Workloads are given as kind:count:priority[:burst] where kind is cpu (always
+ * runnable), io (runs burst ticks then sleeps like `sleep 1`) or short (runs
+ * burst ticks then exits and is replaced). Defaults to one cpu job per level.
+ * -r period:budget[:count] adds always-runnable real-time jobs (see edf.h),
+ * reported with their deadline misses. -g shares[:quota:period] puts the
+ * workloads after it in a new CPU group (see cgroup.h), reported with the
+ * ticks each group got; level targets ignore groups. -a ticks[:max_boost]
+ * turns on aging (see aging.h). -p sets the levels and their weights (see
+ * runqueue.h), and -S cfs schedules by virtual runtime instead of the lottery
+ * (see cfs.h). -m caps the PIDs (see pidmap.h), which short jobs reuse as
+ * they exit. window_dev in the report is the furthest any SIM_WINDOW-tick
+ * window strayed from a level's target. -v adds the ticks and longest wait of
+ * every job to the report.
+ *
+ * Example Usage: ./bin/pennos-sim -t 100000 -s 7 -w cpu:4:0 -w io:8:2:3
+ * Example Usage: ./bin/pennos-sim -p 16,8,4,2,1 -w cpu:1:0 -w cpu:1:4
+ * Example Usage: ./bin/pennos-sim -a 20 -w cpu:50:0 -w cpu:2:2
+ * Example Usage: ./bin/pennos-sim -S cfs -w cpu:4:0 -w cpu:4:2
+ * Example Usage: ./bin/pennos-sim -r 10:3 -r 20:5:2 -w cpu:1:0 -w cpu:1:2
+ * Example Usage: ./bin/pennos-sim -g 1024 -w cpu:1:1 -g 1024:2:10 -w cpu:20:1
+ */
+int main(int argc, char* argv[]) {
+  int num_ticks = SIM_DEFAULT_TICKS;
+  unsigned int seed = 1;
+  char* log_file = NULL;
+  bool verbose = false;
+  int opt;
+  int aging_threshold = 0;
+  int aging_max_boost = AGING_DEFAULT_MAX_BOOST;
+  while ((opt = getopt(argc, argv, "t:s:w:r:g:l:a:p:S:m:v")) != -1) {
+    switch (opt) {
+      case 't':
+        num_ticks = atoi(optarg);
+        break;
+      case 's':
+        seed = strtoul(optarg, NULL, 10);
+        break;
+      case 'w':
+        if (sim_parse_workload(optarg) == -1) {
+          P_ERRNO = EARG;
+          u_error("Invalid workload, expected kind:count:priority[:burst]");
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'r':
+        if (sim_parse_realtime(optarg) == -1) {
+          P_ERRNO = EARG;
+          u_error(
+              "Invalid real-time workload, expected period:budget[:count]");
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'g':
+        if (sim_parse_group(optarg) == -1) {
+          P_ERRNO = EARG;
+          u_error("Invalid CPU group, expected shares[:quota:period]");
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'l':
+        log_file = optarg;
+        break;
+      case 'a':
+        if (sscanf(optarg, "%d:%d", &aging_threshold, &aging_max_boost) < 1 ||
+            k_aging_set(aging_threshold, aging_max_boost) == -1) {
+          P_ERRNO = EARG;
+          u_error("Invalid aging, expected ticks[:max_boost]");
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'p':
+        if (k_levels_parse(optarg) == -1) {
+          P_ERRNO = EARG;
+          u_error("Invalid levels, expected comma separated positive weights");
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'S':
+        if (k_sched_set_policy(optarg) == -1) {
+          P_ERRNO = EARG;
+          u_error("Invalid policy, expected lottery or cfs");
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'm':
+        if (k_pid_set_max(atoi(optarg)) == -1) {
+          P_ERRNO = EARG;
+          u_error("Invalid pid_max");
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'v':
+        verbose = true;
+        break;
+      default:
+        P_ERRNO = EARG;
+        u_error(
+            "usage: pennos-sim [-t ticks] [-s seed] [-w workload] "
+            "[-r period:budget[:count]] [-g shares[:quota:period]] [-l log] "
+            "[-a ticks[:max_boost]] [-p weights] [-S lottery|cfs] "
+            "[-m pid_max] [-v]");
+        exit(EXIT_FAILURE);
+    }
+  }
+  if (num_ticks <= 0) {
+    P_ERRNO = EARG;
+    u_error("Number of ticks must be positive");
+    exit(EXIT_FAILURE);
+  }
+  for (int w = 0; w < num_workloads; w++) {
+    if (workloads[w].priority >= k_num_levels()) {
+      P_ERRNO = EARG;
+      u_error("Workload priority is not a configured level");
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (num_workloads == 0) {
+    for (int i = 0; i < k_num_levels(); i++) {
+      workloads[num_workloads++] =
+          (sim_workload){.kind = SIM_CPU, .count = 1, .priority = i, .burst = 1};
+    }
+  }
+
+  // Without a log file records are dropped once the trace ring fills up
+  if (log_file != NULL) {
+    logfd = open(log_file, O_TRUNC | O_RDWR | O_CREAT, OPEN_FLAG);
+    if (logfd == -1 || k_trace_init(logfd) == -1) {
+      P_ERRNO = EHOST;
+      u_error("Unable to open log file");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  srand(seed);
+  k_allocate_lists();
+  sim_create_groups();
+  for (int i = 0; i < k_num_levels(); i++) {
+    sim_gaps[i] = calloc(num_ticks + 1, sizeof(long));
+  }
+
+  // pid 0 stands in for the shell as the parent of every job; it never runs
+  spthread_t no_thread = {0};
+  sim_root = k_proc_create(NULL, no_thread, STDIN_FILENO, STDOUT_FILENO,
+                           "init", false, NULL);
+  k_block(sim_root);
+  for (int w = 0; w < num_workloads; w++) {
+    for (int i = 0; i < workloads[w].count; i++) {
+      sim_spawn(w);
+    }
+  }
+
+  sim_compute_targets();
+  long level_ticks[MAX_PRIORITY_LEVELS] = {0};
+  long window_ticks[MAX_PRIORITY_LEVELS] = {0};
+  long group_ticks[SIM_MAX_GROUPS + 1] = {0};
+  int idle = 0;
+  int stale = 0;  // ticks lost to a queued pid with no PCB
+  int done = 0;
+  uint64_t start = sim_now_ns();
+  while (ticks < num_ticks) {
+    bool is_idle = false;
+    pcb* this_pcb = next_job(&is_idle);
+    if (is_idle) {
+      idle++;
+    } else if (this_pcb == NULL) {
+      stale++;
+    } else {
+      // real-time ticks are reported per job, not against the level shares
+      if (this_pcb->rt_period == 0) {
+        level_ticks[this_pcb->priority]++;
+        window_ticks[this_pcb->priority]++;
+        group_ticks[this_pcb->cgroup]++;
+      }
+      sim_step(this_pcb);
+      add_job_back(this_pcb);
+      sim_reap(&done);
+    }
+    if (ticks % SIM_WINDOW == 0) {
+      sim_close_window(window_ticks);
+    }
+  }
+  uint64_t elapsed = sim_now_ns() - start;
+
+  sim_report(num_ticks, seed, elapsed, idle, stale, done, level_ticks,
+             group_ticks, verbose);
+
+  k_trace_shutdown();
+  k_free_lists();
+  free(sim_jobs);
+  for (int i = 0; i < k_num_levels(); i++) {
+    free(sim_gaps[i]);
+  }
+  return EXIT_SUCCESS;
+}
+
+#endif  // PENNOS_SIM
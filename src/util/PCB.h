@@ -10,6 +10,7 @@
 #define _DEFAULT_SOURCE 1
 #endif
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <sys/types.h>
@@ -19,22 +20,48 @@
 #include "./globals.h"
 #include "./spthread.h"
 
-// Represents a job
+// Slots of the file descriptor table kept inside the PCB; it only moves to
+// the heap once a process opens a descriptor past them
+#define PCB_FDT_INLINE 4
+
+// Represents a job. The fields the scheduler reads on every tick come first
+// so that they share the PCB's first cache lines.
 typedef struct pcb_st {
   pid_t pid;
   int status;  // referenced in macros.h
-  pid_t parent_pid;
+  int priority;
+  int boost;        // levels aging raised the job by while it waits, 0 if none
+  int queued_tick;  // tick the job last joined a run queue
+  int sleep_duration;  // if not sleeping, set sleep_duration = -1;
+  int cgroup;       // CPU group, see cgroup.h
+  int rt_period;    // ticks per real-time period, 0 for best-effort jobs
+  int rt_budget;    // ticks the job may run in each period
+  int rt_left;      // budget left in the current period
+  int rt_deadline;  // tick the current period ends
+  int rt_misses;    // periods that ended with budget left while runnable
+  uint64_t vruntime;  // weighted ticks run, for the cfs policy
+  uint64_t runnable_ns;  // host time the job last became runnable, 0 if not
+                         // waiting in a priority queue
+  atomic_uint pending_signals;  // bit (signal - P_SIGSTOP) set while that
+                                // signal waits for the next tick
+  bool is_background;
+  bool waiting_any;  // blocked in waitpid(-1), woken by the next ready child
   spthread_t curr_thread;
+
+  pid_t parent_pid;
+  pid_t pgid;  // process group, the pid of the group's first member
   PIDDeque* child_pids;
-  PIDDeque* status_changes;
+  PIDDeque* ready_children;  // children that exited or were terminated, in
+                             // order, waiting to be reaped
   int blocking;  // 0: not blocking, 1: blocking
-  int priority;
-  int sleep_duration;  // if not sleeping, set sleep_duration = -1;
   char* process_name;
   int stop_time;
-  bool is_background;
-  int process_fdt[1024];
   struct parsed_command* parsed;
   int job_id;
+  int* process_fdt;  // process-level file descriptor table: process_fdt[fd]
+                     // is fd while it is open, -1 otherwise. Points at
+                     // fdt_inline until it grows.
+  int fdt_size;      // # entries in process_fdt, at least PCB_FDT_INLINE
+  int fdt_inline[PCB_FDT_INLINE];
 } pcb;
 #endif  // JOB_H_
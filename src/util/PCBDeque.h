@@ -3,6 +3,7 @@
 
 #include <stdbool.h>  // for bool type (true, false)
 #include "PCB.h"
+#include "RingDeque.h"
 #include "globals.h"
 
 #ifndef _POSIX_C_SOURCE
@@ -13,103 +14,22 @@
 #define _DEFAULT_SOURCE 1
 #endif
 
-// A single node within a deque.
-//
-// A node contains next and prev pointers as well as a pointer to a PCB struct.
-typedef struct pcb_dq_node {
-  pcb* pcb;                  // Stores PCB
-  struct pcb_dq_node* next;  // next node in deque, or NULL
-  struct pcb_dq_node* prev;  // prev node in deque, or NULL
-} PCBDqNode;
-
-// The entire Deque.
-// This struct contains metadata about the deque.
-typedef struct dq_st {
-  int num_elements;  //  # elements in the list
-  PCBDqNode* front;  // beginning of deque, or NULL if empty
-  PCBDqNode* back;   // end of deque, or NULL if empty
-} PCBDeque;
-
-// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-// "Methods" for our Deque implementation.
-// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-
-/**
- * @brief Allocates and returns a pointer to a new Deque.
- *
- * @return pointer to the deque, NULL on error
- */
-PCBDeque* PCBDeque_Allocate(void);
+// The PCB Deque is a Ring Deque of PCB pointers (see RingDeque.h) with a PID
+// Index, so every function RingDeque.h lists exists as PCBDeque_*. A PID may
+// only appear once.
+RING_DEQUE_DECLARE(PCBDeque, pcb*)
 
 /**
- * @brief Free a Deque that was previously allocated by Deque_Alocate
+ * @brief Free a Deque that was previously allocated by PCBDeque_Allocate
+ * together with every PCB in it
  *
  * @param deque: the deque pointer to free. Will be unsafe to use after.
  */
-void PCBDeque_Free(PCBDeque* deque);
-
-/**
- * @brief Return the number of elements in the Deque.
- *
- * @param deque: the pointer to the deque we are measuring
- * @return pointer to the deque, NULL on error
- */
-int PCBDeque_Size(PCBDeque* deque);
-
-/**
- * @brief Add a new element to the front of the Deque.
- *
- * @param deque: the pointer to the Deque we are adding to
- * @param payload: the pointer to the struct we are adding
- */
-void PCBDeque_Push_Front(PCBDeque* deque, pcb* payload);
-
-/**
- * @brief Pop an element from the front of the Deque.
- *
- * @param deque: the deque that we are popping from
- * @return true on success, false if the deque is empty or error
- */
-bool PCBDeque_Pop_Front(PCBDeque* deque);
-
-/**
- * @brief Peek at the element at the front of the deque.
- *
- * @param deque: the deque we are peeking at
- * @param payload_ptr: a return parameter; a pointer that will point to the
- * peeked struct
- * @return true on success, false if the deque is empty or error
- */
-bool PCBDeque_Peek_Front(PCBDeque* deque, pcb* payload_ptr);
+void PCBDeque_FreeWithPCBs(PCBDeque* deque);
 
 /**
- * @brief Add a new element to the back of the Deque.
- *
- * @param deque: the pointer to the Deque we are adding to
- * @param payload: the pointer to the struct we are adding
- */
-void PCBDeque_Push_Back(PCBDeque* deque, pcb* payload);
-
-/**
- * @brief Pop an element from the back of the Deque.
- *
- * @param deque: the deque that we are popping from
- * @return true on success, false if the deque is empty or error
- */
-bool PCBDeque_Pop_Back(PCBDeque* deque);
-
-/**
- * @brief Peek at the element at the back of the deque.
- *
- * @param deque: the deque we are peeking at
- * @param payload_ptr: a return parameter; a pointer that will point to the
- * peeked struct
- * @return true on success, false if the deque is empty or error
- */
-bool PCBDeque_Peek_Back(PCBDeque* deque, pcb** payload_ptr);
-
-/**
- * @brief Search the Deque from a struct containing a certain process/jobID
+ * @brief Search the Deque from a struct containing a certain process/jobID in
+ * O(1)
  *
  * @param deque: the deque to search inside
  * @param job_id: the pid that we are looking for
@@ -120,7 +40,7 @@ pcb* PCBDequeJobSearch(PCBDeque* deque, int job_id);
 
 /**
  * @brief Search the Deque from a struct containing a certain process/jobID and
- * delete it
+ * delete it in O(1)
  *
  * @param deque: the deque to search inside
  * @param pgid: the pid that we are looking for
@@ -131,22 +51,14 @@ pcb* PCBDequeJobSearch(PCBDeque* deque, int job_id);
 bool PCBSearchAndDelete(PCBDeque* deque, pid_t pgid, bool shouldFreeNode);
 
 /**
- * @brief Search a Deque for the first job with "STOPPED" status
+ * @brief Frees a batch of PCBs which are no longer in any deque. All of their
+ * threads are cancelled before any is waited on, so tearing down many
+ * processes costs about one thread shutdown rather than one per process.
  *
- * @param deque: the deque to search inside
- * @return A pointer to an element in the deque that matches; NULL if no match
- * found
- */
-pcb* PCBDequeStopSearch(PCBDeque* deque);
-
-/**
- * @brief Search a Deque for the first job that is in the background
- *
- * @param deque: the deque to search inside
- * @return A pointer to an element in the deque that matches; NULL if no match
- * found
+ * @param pcbs: the PCBs to free
+ * @param count: number of PCBs in pcbs
  */
-pcb* PCBDequeBackgroundSearch(PCBDeque* deque);
+void PCBDeque_FreePCBs(pcb** pcbs, int count);
 
 extern PCBDeque* PCBList;  // make PCBList a global var
 
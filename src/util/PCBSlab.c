@@ -0,0 +1,109 @@
+#include "PCBSlab.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE 64
+
+// A free PCB holds the link to the next free one in its own memory
+typedef union slab_slot {
+  pcb proc;
+  union slab_slot* next;
+} slab_slot;
+
+// Every chunk starts with a header linking it to the previously allocated
+// chunk, padded to a cache line so the slots stay aligned
+typedef struct slab_chunk {
+  struct slab_chunk* next;
+} slab_chunk;
+
+#define SLOT_SIZE \
+  ((sizeof(slab_slot) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE)
+
+static slab_chunk* chunks = NULL;
+static slab_slot* free_slots = NULL;
+static int in_use = 0;
+
+static bool grow(void) {
+  size_t size = CACHE_LINE + PCB_SLAB_CHUNK * SLOT_SIZE;
+  slab_chunk* chunk = aligned_alloc(CACHE_LINE, size);
+  if (chunk == NULL) {
+    return false;
+  }
+  chunk->next = chunks;
+  chunks = chunk;
+  // push the slots in reverse so they are handed out in address order
+  char* first = (char*)chunk + CACHE_LINE;
+  for (int i = PCB_SLAB_CHUNK - 1; i >= 0; i--) {
+    slab_slot* slot = (slab_slot*)(first + i * SLOT_SIZE);
+    slot->next = free_slots;
+    free_slots = slot;
+  }
+  return true;
+}
+
+pcb* PCBSlab_Get(void) {
+  if (free_slots == NULL && !grow()) {
+    return NULL;
+  }
+  slab_slot* slot = free_slots;
+  free_slots = slot->next;
+  in_use++;
+  return &slot->proc;
+}
+
+void PCBSlab_Put(pcb* proc) {
+  slab_slot* slot = (slab_slot*)proc;
+  slot->next = free_slots;
+  free_slots = slot;
+  in_use--;
+}
+
+void PCBSlab_Free(void) {
+  while (chunks != NULL) {
+    slab_chunk* next = chunks->next;
+    free(chunks);
+    chunks = next;
+  }
+  free_slots = NULL;
+  in_use = 0;
+}
+
+int PCBSlab_InUse(void) {
+  return in_use;
+}
+
+bool PCB_FDT_Reserve(pcb* proc, int fd) {
+  if (fd < proc->fdt_size) {
+    return true;
+  }
+  int size = proc->fdt_size;
+  while (size <= fd) {
+    size *= 2;
+  }
+  int* fdt;
+  if (proc->process_fdt == proc->fdt_inline) {
+    fdt = malloc(size * sizeof(int));
+    if (fdt != NULL) {
+      memcpy(fdt, proc->fdt_inline, sizeof(proc->fdt_inline));
+    }
+  } else {
+    fdt = realloc(proc->process_fdt, size * sizeof(int));
+  }
+  if (fdt == NULL) {
+    return false;
+  }
+  for (int i = proc->fdt_size; i < size; i++) {
+    fdt[i] = -1;
+  }
+  proc->process_fdt = fdt;
+  proc->fdt_size = size;
+  return true;
+}
+
+void PCB_FDT_Free(pcb* proc) {
+  if (proc->process_fdt != proc->fdt_inline) {
+    free(proc->process_fdt);
+  }
+  proc->process_fdt = proc->fdt_inline;
+  proc->fdt_size = PCB_FDT_INLINE;
+}
@@ -0,0 +1,53 @@
+#ifndef PCBSLAB_H_
+#define PCBSLAB_H_
+
+#include <stdbool.h>
+#include "PCB.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// The PCB Slab hands out PCBs from cache-line aligned chunks of
+// PCB_SLAB_CHUNK PCBs instead of allocating each one separately. Freed PCBs
+// go on a free list and are handed out again first, most recently freed
+// first, so spawning reuses memory that is likely still in cache. Chunks are
+// only returned to the host when the slab is freed.
+///////////////////////////////////////////////////////////////////////////////
+
+#define PCB_SLAB_CHUNK 64
+
+/** @brief Returns an uninitialised PCB.
+ *
+ * @return the PCB, or NULL on error.
+ */
+pcb* PCBSlab_Get(void);
+
+/** @brief Returns a PCB to the slab. Its file descriptor table must already
+ * have been freed.
+ *
+ * @param proc a PCB from PCBSlab_Get.
+ */
+void PCBSlab_Put(pcb* proc);
+
+/** @brief Frees every chunk of the slab. No PCB may be used afterwards.
+ */
+void PCBSlab_Free(void);
+
+/** @brief Returns the number of PCBs handed out and not yet returned.
+ */
+int PCBSlab_InUse(void);
+
+/** @brief Makes room in a process's file descriptor table for fd, doubling
+ * it as needed. New entries are -1.
+ *
+ * @param proc the process.
+ * @param fd a non-negative file descriptor.
+ * @return true on success, false on error.
+ */
+bool PCB_FDT_Reserve(pcb* proc, int fd);
+
+/** @brief Frees a process's file descriptor table if it outgrew the PCB.
+ *
+ * @param proc the process.
+ */
+void PCB_FDT_Free(pcb* proc);
+
+#endif
@@ -0,0 +1,151 @@
+#include "PIDHeap.h"
+#include <stdlib.h>
+
+static bool less(const PIDHeapNode* a, const PIDHeapNode* b) {
+  return a->key < b->key || (a->key == b->key && a->seq < b->seq);
+}
+
+// Links two detached trees, making the larger root the leftmost child of the
+// smaller one, and returns the new root
+static PIDHeapNode* meld(PIDHeapNode* a, PIDHeapNode* b) {
+  if (less(b, a)) {
+    PIDHeapNode* tmp = a;
+    a = b;
+    b = tmp;
+  }
+  b->sibling = a->child;
+  if (a->child != NULL) {
+    a->child->prev = b;
+  }
+  b->prev = a;
+  a->child = b;
+  return a;
+}
+
+// Two-pass pairing: melds the siblings starting at first in pairs from left
+// to right, then melds the pairs into one tree from right to left
+static PIDHeapNode* merge_pairs(PIDHeapNode* first) {
+  if (first == NULL) {
+    return NULL;
+  }
+  PIDHeapNode* pairs = NULL;  // melded pairs, last first, linked by sibling
+  while (first != NULL) {
+    PIDHeapNode* a = first;
+    PIDHeapNode* b = a->sibling;
+    first = b != NULL ? b->sibling : NULL;
+    a->sibling = NULL;
+    if (b != NULL) {
+      b->sibling = NULL;
+      a = meld(a, b);
+    }
+    a->sibling = pairs;
+    pairs = a;
+  }
+  PIDHeapNode* root = pairs;
+  pairs = pairs->sibling;
+  root->sibling = NULL;
+  while (pairs != NULL) {
+    PIDHeapNode* next = pairs->sibling;
+    pairs->sibling = NULL;
+    root = meld(root, pairs);
+    pairs = next;
+  }
+  root->prev = NULL;
+  return root;
+}
+
+PIDHeap* PIDHeap_Allocate(void) {
+  PIDHeap* heap = malloc(sizeof(PIDHeap));
+  if (heap == NULL) {
+    return NULL;
+  }
+  heap->root = NULL;
+  heap->size = 0;
+  heap->pushes = 0;
+  heap->index = PIDIndex_Allocate();
+  if (heap->index == NULL) {
+    free(heap);
+    return NULL;
+  }
+  return heap;
+}
+
+void PIDHeap_Free(PIDHeap* heap) {
+  // every node is in the index, so free them from there instead of walking
+  // the tree
+  for (int i = 0; i < heap->index->capacity; i++) {
+    free(heap->index->values[i]);
+  }
+  PIDIndex_Free(heap->index);
+  free(heap);
+}
+
+int PIDHeap_Size(PIDHeap* heap) {
+  return heap->size;
+}
+
+bool PIDHeap_Push(PIDHeap* heap, pid_t pid, uint64_t key) {
+  PIDHeapNode* node = malloc(sizeof(PIDHeapNode));
+  if (node == NULL) {
+    return false;
+  }
+  if (!PIDIndex_Put(heap->index, pid, node)) {
+    free(node);
+    return false;
+  }
+  *node = (PIDHeapNode){.pid = pid, .key = key, .seq = heap->pushes++};
+  heap->root = heap->root != NULL ? meld(heap->root, node) : node;
+  heap->size++;
+  return true;
+}
+
+bool PIDHeap_Peek_Min(PIDHeap* heap, pid_t* pid, uint64_t* key) {
+  if (heap->root == NULL) {
+    return false;
+  }
+  *pid = heap->root->pid;
+  if (key != NULL) {
+    *key = heap->root->key;
+  }
+  return true;
+}
+
+bool PIDHeap_Pop_Min(PIDHeap* heap, pid_t* pid) {
+  if (heap->root == NULL) {
+    return false;
+  }
+  *pid = heap->root->pid;
+  return PIDHeap_Remove(heap, *pid);
+}
+
+bool PIDHeap_Contains(PIDHeap* heap, pid_t pid) {
+  return PIDIndex_Get(heap->index, pid) != NULL;
+}
+
+bool PIDHeap_Remove(PIDHeap* heap, pid_t pid) {
+  PIDHeapNode* node = PIDIndex_Get(heap->index, pid);
+  if (node == NULL) {
+    return false;
+  }
+  PIDIndex_Remove(heap->index, pid);
+  PIDHeapNode* children = merge_pairs(node->child);
+  if (node == heap->root) {
+    heap->root = children;
+  } else {
+    // cut the node's subtree out of its parent's child list
+    if (node->prev->child == node) {
+      node->prev->child = node->sibling;
+    } else {
+      node->prev->sibling = node->sibling;
+    }
+    if (node->sibling != NULL) {
+      node->sibling->prev = node->prev;
+    }
+    if (children != NULL) {
+      heap->root = meld(heap->root, children);
+    }
+  }
+  heap->size--;
+  free(node);
+  return true;
+}
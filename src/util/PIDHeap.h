@@ -0,0 +1,96 @@
+#ifndef PIDHEAP_H_
+#define PIDHEAP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "PIDIndex.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// A PID Heap is a min pairing heap of PIDs ordered by a 64-bit key. PIDs with
+// equal keys come out in the order they were pushed. Push is O(1), and pop
+// and removal of any PID are O(log n) amortized. Like the deques it keeps a
+// PID Index from each PID to its node, so a PID can be removed without a
+// search.
+///////////////////////////////////////////////////////////////////////////////
+
+/** @brief A single node within a heap.
+ *
+ * prev is the parent if the node is the leftmost child, or else the previous
+ * sibling.
+ */
+typedef struct pid_heap_node {
+  pid_t pid;
+  uint64_t key;
+  uint64_t seq;  // push order, breaks ties between equal keys
+  struct pid_heap_node* child;    // leftmost child, or NULL
+  struct pid_heap_node* sibling;  // next sibling, or NULL
+  struct pid_heap_node* prev;     // parent or previous sibling, or NULL
+} PIDHeapNode;
+
+typedef struct pid_heap {
+  PIDHeapNode* root;  // node with the smallest key, or NULL if empty
+  int size;           // # PIDs in the heap
+  uint64_t pushes;    // # pushes so far, the seq of the next node
+  PIDIndex* index;    // pid -> node, for O(1) lookup before removal
+} PIDHeap;
+
+/** @brief Allocates and returns a pointer to a new, empty heap.
+ *
+ * @return the newly-allocated heap, or NULL on error.
+ */
+PIDHeap* PIDHeap_Allocate(void);
+
+/** @brief Frees a heap previously allocated by PIDHeap_Allocate.
+ *
+ * @param heap the heap to free.
+ */
+void PIDHeap_Free(PIDHeap* heap);
+
+/** @brief Returns the number of PIDs in the heap.
+ */
+int PIDHeap_Size(PIDHeap* heap);
+
+/** @brief Adds a PID with the given key, unless it is already in the heap.
+ *
+ * @param heap the heap to push onto.
+ * @param pid a non-negative PID.
+ * @param key the key to order the PID by.
+ * @return true if pushed, false if pid was already present or on error.
+ */
+bool PIDHeap_Push(PIDHeap* heap, pid_t pid, uint64_t key);
+
+/** @brief Peeks at the PID with the smallest key.
+ *
+ * @param heap the heap to peek.
+ * @param pid a return parameter for the PID.
+ * @param key a return parameter for its key, or NULL.
+ * @return false if the heap is empty, true on success.
+ */
+bool PIDHeap_Peek_Min(PIDHeap* heap, pid_t* pid, uint64_t* key);
+
+/** @brief Removes the PID with the smallest key.
+ *
+ * @param heap the heap to pop from.
+ * @param pid a return parameter for the popped PID.
+ * @return false if the heap is empty, true on success.
+ */
+bool PIDHeap_Pop_Min(PIDHeap* heap, pid_t* pid);
+
+/** @brief Checks whether a PID is in the heap, in O(1).
+ *
+ * @param heap the heap to search.
+ * @param pid the PID to look for.
+ * @return true if the PID is in the heap.
+ */
+bool PIDHeap_Contains(PIDHeap* heap, pid_t pid);
+
+/** @brief Removes a PID from anywhere in the heap.
+ *
+ * @param heap the heap to modify.
+ * @param pid the PID to remove.
+ * @return true if the PID was removed, false if it was not in the heap.
+ */
+bool PIDHeap_Remove(PIDHeap* heap, pid_t pid);
+
+#endif
@@ -0,0 +1,42 @@
+#include "PIDIndex.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 8
+
+// Grows the array to the smallest power of two above pid
+bool PIDIndex_Grow(PIDIndex* index, pid_t pid) {
+  int capacity = index->capacity;
+  while (capacity <= pid) {
+    capacity *= 2;
+  }
+  void** values = realloc(index->values, capacity * sizeof(void*));
+  if (values == NULL) {
+    return false;
+  }
+  memset(values + index->capacity, 0,
+         (capacity - index->capacity) * sizeof(void*));
+  index->values = values;
+  index->capacity = capacity;
+  return true;
+}
+
+PIDIndex* PIDIndex_Allocate(void) {
+  PIDIndex* index = malloc(sizeof(PIDIndex));
+  if (index == NULL) {
+    return NULL;
+  }
+  index->size = 0;
+  index->capacity = INITIAL_CAPACITY;
+  index->values = calloc(INITIAL_CAPACITY, sizeof(void*));
+  if (index->values == NULL) {
+    free(index);
+    return NULL;
+  }
+  return index;
+}
+
+void PIDIndex_Free(PIDIndex* index) {
+  free(index->values);
+  free(index);
+}
@@ -0,0 +1,88 @@
+#ifndef PIDINDEX_H_
+#define PIDINDEX_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// A PID Index maps PIDs to pointers. The deques keep one mapping each PID to
+// its node so that searching for and unlinking a PID does not have to walk the
+// whole deque. PIDs are reused below pid_max (see pidmap.h), so the index is
+// an array indexed by PID that doubles until it covers the largest PID stored.
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct pid_index {
+  int capacity;   // number of slots, always a power of two
+  int size;       // number of PIDs stored
+  void** values;  // value stored for each PID, NULL if the PID is absent
+} PIDIndex;
+
+/** @brief Allocates and returns a pointer to a new, empty index.
+ *
+ * @return the newly-allocated index, or NULL on error.
+ */
+PIDIndex* PIDIndex_Allocate(void);
+
+/** @brief Frees an index previously allocated by PIDIndex_Allocate. The values
+ * it points to are not freed.
+ *
+ * @param index the index to free.
+ */
+void PIDIndex_Free(PIDIndex* index);
+
+/** @brief Grows the index to cover pid. Used by PIDIndex_Put.
+ *
+ * @return true on success, false on error.
+ */
+bool PIDIndex_Grow(PIDIndex* index, pid_t pid);
+
+// The lookups are inline: the deques make several on every push and pop.
+
+/** @brief Looks up the value stored for a PID.
+ *
+ * @param index the index to search.
+ * @param pid the PID to look for.
+ * @return the stored value, or NULL if pid is not in the index.
+ */
+static inline void* PIDIndex_Get(PIDIndex* index, pid_t pid) {
+  if (pid < 0 || pid >= index->capacity) {
+    return NULL;
+  }
+  return index->values[pid];
+}
+
+/** @brief Maps pid to value, unless pid is already in the index.
+ *
+ * @param index the index to insert into.
+ * @param pid a non-negative PID.
+ * @param value the non-NULL value to store.
+ * @return true if inserted, false if pid was already present or on error.
+ */
+static inline bool PIDIndex_Put(PIDIndex* index, pid_t pid, void* value) {
+  if (pid < 0 || value == NULL ||
+      (pid >= index->capacity && !PIDIndex_Grow(index, pid)) ||
+      index->values[pid] != NULL) {
+    return false;
+  }
+  index->values[pid] = value;
+  index->size++;
+  return true;
+}
+
+/** @brief Removes a PID from the index.
+ *
+ * @param index the index to modify.
+ * @param pid the PID to remove.
+ * @return true if pid was removed, false if it was not present.
+ */
+static inline bool PIDIndex_Remove(PIDIndex* index, pid_t pid) {
+  if (PIDIndex_Get(index, pid) == NULL) {
+    return false;
+  }
+  index->values[pid] = NULL;
+  index->size--;
+  return true;
+}
+
+#endif
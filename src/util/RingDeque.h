@@ -0,0 +1,351 @@
+#ifndef RINGDEQUE_H_
+#define RINGDEQUE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include "PIDIndex.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// A Ring Deque is a double ended queue kept in one circular array, which
+// doubles when it is full. Pushing and popping at either end allocate nothing
+// once the array is big enough, and walking the deque reads consecutive
+// memory. The PID and PCB deques are both generated from it:
+//
+//   RING_DEQUE_DECLARE(Name, T) declares the struct Name, holding entries of
+//   type T, and its functions (in a header).
+//   RING_DEQUE_DEFINE(Name, T, EMPTY, KEY, INDEXED) defines the functions (in
+//   one .c file). EMPTY is a value no entry ever has, KEY(entry) gives the
+//   PID an entry is found by, and INDEXED is 1 to keep a PID Index.
+//
+// With the index, finding or removing the entry for a PID anywhere in the
+// deque is O(1); without it that walks the deque. Removing an entry from the
+// middle leaves a hole (an EMPTY slot) which popping and iteration skip.
+// Holes at either end are dropped at once, and a push that finds the array
+// full packs the entries together instead of growing if half of it is holes.
+//
+// A PID may be in a deque more than once. The index then points at one of
+// its entries, and removing that entry points it at another.
+//
+// Entries are addressed by 32-bit positions that wrap around: the entry at
+// position p sits in slot p mod capacity. Growing keeps every position, so a
+// cursor from Name_Begin stays valid while entries are removed. Packing moves
+// entries, so a deque must not be pushed onto while it is being walked.
+//
+// The generated functions are:
+//   Name* Name_Allocate(void)            new empty deque, or NULL on error
+//   void Name_Free(Name*)                frees the deque but not its entries
+//   int Name_Size(Name*)                 # entries
+//   bool Name_Push_Front(Name*, T)       false on error
+//   bool Name_Push_Back(Name*, T)        false on error
+//   bool Name_Pop_Front(Name*, T* out)   false if empty; out may be NULL
+//   bool Name_Pop_Back(Name*, T* out)    false if empty; out may be NULL
+//   bool Name_Peek_Front(Name*, T* out)  false if empty
+//   bool Name_Peek_Back(Name*, T* out)   false if empty
+//   bool Name_Find(Name*, pid_t, T* out) false if no entry has the PID
+//   bool Name_Remove(Name*, pid_t, T* out)  removes the first entry found
+//   uint32_t Name_Begin(Name*)           cursor at the front
+//   bool Name_Next(Name*, uint32_t* cursor, T* out)
+//       the entry at or after the cursor and advances past it, false at the
+//       back
+///////////////////////////////////////////////////////////////////////////////
+
+#define RING_DEQUE_INITIAL_CAPACITY 8
+
+// The slot holding the entry at position pos
+#define RING_DEQUE_SLOT(deque, pos) \
+  ((deque)->items[(pos) & ((deque)->capacity - 1)])
+
+#define RING_DEQUE_DECLARE(Name, T)                                     \
+  typedef struct Name {                                                 \
+    T* items;          /* capacity slots, NULL until the first push */  \
+    uint32_t capacity; /* 0 or a power of two */                        \
+    uint32_t start;    /* position of the front entry */                \
+    uint32_t end;      /* position after the back entry */              \
+    int num_elements;  /* # entries, not counting holes */              \
+    PIDIndex* index;   /* pid -> position + 1, NULL if not indexed */   \
+    int unindexed;     /* # entries whose PID is indexed via another */ \
+  } Name;                                                               \
+                                                                        \
+  Name* Name##_Allocate(void);                                          \
+  void Name##_Free(Name* deque);                                        \
+  int Name##_Size(Name* deque);                                         \
+  bool Name##_Push_Front(Name* deque, T item);                          \
+  bool Name##_Push_Back(Name* deque, T item);                           \
+  bool Name##_Pop_Front(Name* deque, T* out);                           \
+  bool Name##_Pop_Back(Name* deque, T* out);                            \
+  bool Name##_Peek_Front(Name* deque, T* out);                          \
+  bool Name##_Peek_Back(Name* deque, T* out);                           \
+  bool Name##_Find(Name* deque, pid_t pid, T* out);                     \
+  bool Name##_Remove(Name* deque, pid_t pid, T* out);                   \
+  uint32_t Name##_Begin(Name* deque);                                   \
+  bool Name##_Next(Name* deque, uint32_t* cursor, T* out);
+
+#define RING_DEQUE_DEFINE(Name, T, EMPTY, KEY, INDEXED)                       \
+  static bool Name##_indexed_at(Name* deque, pid_t pid, uint32_t* pos) {      \
+    void* value = PIDIndex_Get(deque->index, pid);                            \
+    if (value == NULL) {                                                      \
+      return false;                                                           \
+    }                                                                         \
+    *pos = (uint32_t)((uintptr_t)value - 1);                                  \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  static void Name##_index(Name* deque, T item, uint32_t pos) {               \
+    if (deque->index != NULL &&                                               \
+        !PIDIndex_Put(deque->index, KEY(item),                                \
+                      (void*)((uintptr_t)pos + 1))) {                         \
+      deque->unindexed++;                                                     \
+    }                                                                         \
+  }                                                                           \
+                                                                              \
+  /* Moves the entry at pos in the index to new_pos, if it is indexed */      \
+  static void Name##_reindex(Name* deque, T item, uint32_t pos,               \
+                             uint32_t new_pos) {                              \
+    uint32_t at;                                                              \
+    if (deque->index != NULL && pos != new_pos &&                             \
+        Name##_indexed_at(deque, KEY(item), &at) && at == pos) {              \
+      PIDIndex_Remove(deque->index, KEY(item));                               \
+      PIDIndex_Put(deque->index, KEY(item), (void*)((uintptr_t)new_pos + 1)); \
+    }                                                                         \
+  }                                                                           \
+                                                                              \
+  /* Drops the entry removed from pos from the index, pointing the index at   \
+   * another entry with the same PID if there is one */                       \
+  static void Name##_unindex(Name* deque, T item, uint32_t pos) {             \
+    uint32_t at;                                                              \
+    if (deque->index == NULL) {                                               \
+      return;                                                                 \
+    }                                                                         \
+    /* without duplicates every entry is indexed at its own position */       \
+    if (deque->unindexed == 0) {                                              \
+      PIDIndex_Remove(deque->index, KEY(item));                               \
+      return;                                                                 \
+    }                                                                         \
+    if (!Name##_indexed_at(deque, KEY(item), &at) || at != pos) {             \
+      deque->unindexed--;                                                     \
+      return;                                                                 \
+    }                                                                         \
+    PIDIndex_Remove(deque->index, KEY(item));                                 \
+    /* rare: the PID was in the deque more than once */                       \
+    for (uint32_t p = deque->start; p != deque->end; p++) {                   \
+      T other = RING_DEQUE_SLOT(deque, p);                                    \
+      if (other != EMPTY && KEY(other) == KEY(item)) {                        \
+        PIDIndex_Put(deque->index, KEY(other), (void*)((uintptr_t)p + 1));    \
+        deque->unindexed--;                                                   \
+        return;                                                               \
+      }                                                                       \
+    }                                                                         \
+  }                                                                           \
+                                                                              \
+  /* Moves the entries to a new array, packing them together from the front   \
+   * position if pack is set and otherwise keeping their positions */         \
+  static bool Name##_resize(Name* deque, uint32_t capacity, bool pack) {      \
+    T* items = malloc(capacity * sizeof(T));                                  \
+    if (items == NULL) {                                                      \
+      return false;                                                           \
+    }                                                                         \
+    uint32_t new_pos = deque->start;                                          \
+    for (uint32_t p = deque->start; p != deque->end; p++) {                   \
+      T item = RING_DEQUE_SLOT(deque, p);                                     \
+      if (!pack) {                                                            \
+        items[p & (capacity - 1)] = item;                                     \
+      } else if (item != EMPTY) {                                             \
+        items[new_pos & (capacity - 1)] = item;                               \
+        Name##_reindex(deque, item, p, new_pos);                              \
+        new_pos++;                                                            \
+      }                                                                       \
+    }                                                                         \
+    if (pack) {                                                               \
+      deque->end = new_pos;                                                   \
+    }                                                                         \
+    free(deque->items);                                                       \
+    deque->items = items;                                                     \
+    deque->capacity = capacity;                                               \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  /* Makes room for one more entry */                                         \
+  static bool Name##_reserve(Name* deque) {                                   \
+    uint32_t used = deque->end - deque->start;                                \
+    if (used < deque->capacity) {                                             \
+      return true;                                                            \
+    }                                                                         \
+    if (used > 0 && (used - deque->num_elements) * 2 >= used) {               \
+      return Name##_resize(deque, deque->capacity, true);                     \
+    }                                                                         \
+    return Name##_resize(deque, deque->capacity == 0                          \
+                                    ? RING_DEQUE_INITIAL_CAPACITY             \
+                                    : deque->capacity * 2,                    \
+                         false);                                              \
+  }                                                                           \
+                                                                              \
+  static void Name##_remove_at(Name* deque, uint32_t pos) {                   \
+    T* slot = &RING_DEQUE_SLOT(deque, pos);                                   \
+    T item = *slot;                                                           \
+    *slot = EMPTY;                                                            \
+    deque->num_elements--;                                                    \
+    Name##_unindex(deque, item, pos);                                         \
+    /* drop the holes the entry leaves at either end */                       \
+    if (deque->num_elements == 0) {                                           \
+      deque->start = deque->end;                                              \
+    } else if (pos == deque->start) {                                         \
+      while (RING_DEQUE_SLOT(deque, deque->start) == EMPTY) {                 \
+        deque->start++;                                                       \
+      }                                                                       \
+    } else if (pos == deque->end - 1) {                                       \
+      while (RING_DEQUE_SLOT(deque, deque->end - 1) == EMPTY) {               \
+        deque->end--;                                                         \
+      }                                                                       \
+    }                                                                         \
+  }                                                                           \
+                                                                              \
+  /* Returns the position of an entry with the PID, or false if none has */   \
+  static bool Name##_locate(Name* deque, pid_t pid, uint32_t* pos) {          \
+    if (deque->index != NULL) {                                               \
+      return Name##_indexed_at(deque, pid, pos);                              \
+    }                                                                         \
+    for (uint32_t p = deque->start; p != deque->end; p++) {                   \
+      T item = RING_DEQUE_SLOT(deque, p);                                     \
+      if (item != EMPTY && KEY(item) == pid) {                                \
+        *pos = p;                                                             \
+        return true;                                                          \
+      }                                                                       \
+    }                                                                         \
+    return false;                                                             \
+  }                                                                           \
+                                                                              \
+  Name* Name##_Allocate(void) {                                               \
+    Name* deque = calloc(1, sizeof(Name));                                    \
+    if (deque == NULL) {                                                      \
+      return NULL;                                                            \
+    }                                                                         \
+    if (INDEXED) {                                                            \
+      deque->index = PIDIndex_Allocate();                                     \
+      if (deque->index == NULL) {                                             \
+        free(deque);                                                          \
+        return NULL;                                                          \
+      }                                                                       \
+    }                                                                         \
+    return deque;                                                             \
+  }                                                                           \
+                                                                              \
+  void Name##_Free(Name* deque) {                                             \
+    if (deque->index != NULL) {                                               \
+      PIDIndex_Free(deque->index);                                            \
+    }                                                                         \
+    free(deque->items);                                                       \
+    free(deque);                                                              \
+  }                                                                           \
+                                                                              \
+  int Name##_Size(Name* deque) {                                              \
+    return deque->num_elements;                                               \
+  }                                                                           \
+                                                                              \
+  bool Name##_Push_Front(Name* deque, T item) {                               \
+    if (deque->end - deque->start == deque->capacity &&                       \
+        !Name##_reserve(deque)) {                                             \
+      return false;                                                           \
+    }                                                                         \
+    deque->start--;                                                           \
+    RING_DEQUE_SLOT(deque, deque->start) = item;                              \
+    deque->num_elements++;                                                    \
+    Name##_index(deque, item, deque->start);                                  \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  bool Name##_Push_Back(Name* deque, T item) {                                \
+    if (deque->end - deque->start == deque->capacity &&                       \
+        !Name##_reserve(deque)) {                                             \
+      return false;                                                           \
+    }                                                                         \
+    RING_DEQUE_SLOT(deque, deque->end) = item;                                \
+    deque->num_elements++;                                                    \
+    Name##_index(deque, item, deque->end);                                    \
+    deque->end++;                                                             \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  bool Name##_Peek_Front(Name* deque, T* out) {                               \
+    if (deque->num_elements == 0) {                                           \
+      return false;                                                           \
+    }                                                                         \
+    *out = RING_DEQUE_SLOT(deque, deque->start);                              \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  bool Name##_Peek_Back(Name* deque, T* out) {                                \
+    if (deque->num_elements == 0) {                                           \
+      return false;                                                           \
+    }                                                                         \
+    *out = RING_DEQUE_SLOT(deque, deque->end - 1);                            \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  bool Name##_Pop_Front(Name* deque, T* out) {                                \
+    if (deque->num_elements == 0) {                                           \
+      return false;                                                           \
+    }                                                                         \
+    if (out != NULL) {                                                        \
+      *out = RING_DEQUE_SLOT(deque, deque->start);                            \
+    }                                                                         \
+    Name##_remove_at(deque, deque->start);                                    \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  bool Name##_Pop_Back(Name* deque, T* out) {                                 \
+    if (deque->num_elements == 0) {                                           \
+      return false;                                                           \
+    }                                                                         \
+    if (out != NULL) {                                                        \
+      *out = RING_DEQUE_SLOT(deque, deque->end - 1);                          \
+    }                                                                         \
+    Name##_remove_at(deque, deque->end - 1);                                  \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  bool Name##_Find(Name* deque, pid_t pid, T* out) {                          \
+    uint32_t pos;                                                             \
+    if (!Name##_locate(deque, pid, &pos)) {                                   \
+      return false;                                                           \
+    }                                                                         \
+    if (out != NULL) {                                                        \
+      *out = RING_DEQUE_SLOT(deque, pos);                                     \
+    }                                                                         \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  bool Name##_Remove(Name* deque, pid_t pid, T* out) {                        \
+    uint32_t pos;                                                             \
+    if (!Name##_locate(deque, pid, &pos)) {                                   \
+      return false;                                                           \
+    }                                                                         \
+    if (out != NULL) {                                                        \
+      *out = RING_DEQUE_SLOT(deque, pos);                                     \
+    }                                                                         \
+    Name##_remove_at(deque, pos);                                             \
+    return true;                                                              \
+  }                                                                           \
+                                                                              \
+  uint32_t Name##_Begin(Name* deque) {                                        \
+    return deque->start;                                                      \
+  }                                                                           \
+                                                                              \
+  bool Name##_Next(Name* deque, uint32_t* cursor, T* out) {                   \
+    /* entries before the cursor may have been popped since */                \
+    if ((int32_t)(*cursor - deque->start) < 0) {                              \
+      *cursor = deque->start;                                                 \
+    }                                                                         \
+    while (*cursor - deque->start < deque->end - deque->start) {              \
+      T item = RING_DEQUE_SLOT(deque, *cursor);                               \
+      (*cursor)++;                                                            \
+      if (item != EMPTY) {                                                    \
+        *out = item;                                                          \
+        return true;                                                          \
+      }                                                                       \
+    }                                                                         \
+    return false;                                                             \
+  }
+
+#endif
@@ -1,6 +1,10 @@
 #include "./builtins.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "../kernel/aging.h"
+#include "../kernel/cgroup.h"
+#include "../kernel/shm.h"
 #include "./globals.h"
 
 int num_arg(char** args) {
@@ -43,6 +47,18 @@ void* ps(void* arg) {
   return NULL;
 }
 
+void* schedstat(void* arg) {
+  s_schedstat();
+  s_exit();
+  return NULL;
+}
+
+void* cgstat(void* arg) {
+  s_cgstat();
+  s_exit();
+  return NULL;
+}
+
 void* os_kill(void* arg) {
   char** args = (char**)arg;
   int signal = P_SIGTERM;
@@ -71,7 +87,12 @@ void* os_kill(void* arg) {
       s_exit();
       return NULL;
     }
-    s_kill(pid, signal);
+    // a negative pid names a process group
+    if (pid < 0) {
+      s_killpg(-pid, signal);
+    } else {
+      s_kill(pid, signal);
+    }
     process_start++;
   }
 
@@ -393,13 +414,20 @@ void* touch(void* arg) {
   // Check # of Arguments
   int arg_count = num_arg(args);
 
-  // Call s_touch for each file
-  for (int i = 1; i < arg_count; i++) {
-    if (s_touch(args[i]) == -1) {
-      s_exit();
-      return NULL;
-    };
+  // Touch every file in one batch, so the directory is read and written once
+  int num_files = arg_count - 1;
+  p_subentry* ops = malloc(arg_count * sizeof(p_subentry));
+  if (ops == NULL) {
+    P_ERRNO = EHOST;
+    u_error("touch: out of memory");
+    s_exit();
+    return NULL;
+  }
+  for (int i = 0; i < num_files; i++) {
+    ops[i] = (p_subentry){.op = P_SUB_TOUCH, .fname = args[i + 1]};
   }
+  s_submit(ops, num_files);
+  free(ops);
 
   s_exit();
 
@@ -478,20 +506,20 @@ void* cp(void* arg) {
       return NULL;
     }
 
-    // Read from SOURCE and write to DEST
-    while (1) {
-      char buffer[1024];
-      int num_bytes = s_read(fd_read, 1024, buffer);
+    // Read the next chunk of SOURCE while writing this one to DEST
+    char buffers[2][1024];
+    int ticket = s_aread(fd_read, 1024, buffers[0]);
+    for (int curr = 0;; curr = 1 - curr) {
+      int num_bytes = ticket == -1 ? -1 : s_await(ticket);
       if (num_bytes == -1) {
         s_exit();
         return NULL;
       } else if (num_bytes == 0) {
         break;
-      } else {
-        buffer[num_bytes] = '\0';
       }
 
-      if (s_write(fd_write, buffer, num_bytes) == -1) {
+      ticket = s_aread(fd_read, 1024, buffers[1 - curr]);
+      if (s_write(fd_write, buffers[curr], num_bytes) == -1) {
         s_exit();
         return NULL;
       }
@@ -706,6 +734,485 @@ void* nice_pid(void* arg) {
   return NULL;
 }
 
+/**
+ * @brief Puts an existing process in the real-time class, running it for
+ * budget ticks every period ticks, or takes it out with 0 0.
+ *
+ * Example Usage: rt_pid 10 2 123 (PID 123 runs 2 ticks in every 10)
+ * Example Usage: rt_pid 0 0 123 (PID 123 goes back to its priority level)
+ */
+void* rt_pid(void* arg) {
+  char** args = (char**)arg;
+  if (args[1] == NULL || args[2] == NULL || args[3] == NULL) {
+    P_ERRNO = EARG;
+    u_error("rt_pid");
+    return NULL;
+  }
+  int period = atoi(args[1]);
+  int budget = atoi(args[2]);
+  pid_t pid = atoi(args[3]);
+  if (s_sched_setattr(pid, period, budget) < 0) {
+    u_error("rt_pid");
+  }
+  return NULL;
+}
+
+/**
+ * @brief Creates, configures or destroys CPU groups and moves processes into
+ * them. set without a quota removes the group's quota.
+ *
+ * Example Usage: cgroup create tenant1 (a group under the root)
+ * Example Usage: cgroup create batch tenant1 (a group under tenant1)
+ * Example Usage: cgroup set tenant1 2048 5 10 (double shares, 5 ticks in 10)
+ * Example Usage: cgroup add tenant1 123 (moves PID 123 into tenant1)
+ * Example Usage: cgroup delete tenant1
+ */
+void* cgroup(void* arg) {
+  char** args = (char**)arg;
+  if (args[1] == NULL || args[2] == NULL) {
+    P_ERRNO = EARG;
+    u_error("cgroup");
+    return NULL;
+  }
+  int res;
+  if (strcmp(args[1], "create") == 0) {
+    res = s_cgroup_create(args[2], args[3]);
+  } else if (strcmp(args[1], "delete") == 0) {
+    res = s_cgroup_destroy(args[2]);
+  } else if (strcmp(args[1], "set") == 0 && args[3] != NULL) {
+    bool has_quota = args[4] != NULL && args[5] != NULL;
+    res = s_cgroup_set(args[2], atoi(args[3]), has_quota ? atoi(args[4]) : 0,
+                       has_quota ? atoi(args[5]) : CGROUP_DEFAULT_PERIOD);
+  } else if (strcmp(args[1], "add") == 0 && args[3] != NULL) {
+    res = s_cgroup_attach(atoi(args[3]), args[2]);
+  } else {
+    P_ERRNO = EARG;
+    res = -1;
+  }
+  if (res < 0) {
+    u_error("cgroup");
+  }
+  return NULL;
+}
+
+/**
+ * @brief Turns anti-starvation aging on or off. Jobs which wait `ticks` ticks
+ * in their queue are boosted one level, up to `max_boost` (default 2) levels.
+ *
+ * Example Usage: aging 20 (boost after 20 ticks of waiting)
+ * Example Usage: aging 20 1 (never boost by more than one level)
+ * Example Usage: aging off
+ */
+void* aging(void* arg) {
+  char** args = (char**)arg;
+  if (args[1] == NULL) {
+    P_ERRNO = EARG;
+    u_error("aging");
+    return NULL;
+  }
+  int threshold = strcmp(args[1], "off") == 0 ? 0 : atoi(args[1]);
+  int max_boost = args[2] != NULL ? atoi(args[2]) : AGING_DEFAULT_MAX_BOOST;
+  if ((threshold == 0 && strcmp(args[1], "off") != 0) ||
+      s_aging(threshold, max_boost) < 0) {
+    P_ERRNO = EARG;
+    u_error("aging");
+  }
+  return NULL;
+}
+
+/**
+ * @brief Creates, posts, waits on or deletes a named semaphore. wait blocks
+ * the process until a post hands it a unit, so producers and consumers can
+ * be chained without polling. -p wakes waiters by priority instead of in
+ * arrival order.
+ *
+ * Example Usage: sem create items (a semaphore with count 0)
+ * Example Usage: sem create slots 4 -p (count 4, waiters woken by priority)
+ * Example Usage: sem wait items &
+ * Example Usage: sem post items
+ * Example Usage: sem delete items
+ */
+void* sem(void* arg) {
+  char** args = (char**)arg;
+  if (args[1] == NULL || args[2] == NULL) {
+    P_ERRNO = EARG;
+    u_error("sem");
+    s_exit();
+    return NULL;
+  }
+  int res;
+  if (strcmp(args[1], "create") == 0) {
+    bool has_value = args[3] != NULL && strcmp(args[3], "-p") != 0;
+    char* flag = has_value ? args[4] : args[3];
+    bool by_priority = flag != NULL && strcmp(flag, "-p") == 0;
+    res = s_sem_create(args[2], has_value ? atoi(args[3]) : 0, by_priority);
+  } else if (strcmp(args[1], "post") == 0 || strcmp(args[1], "wait") == 0 ||
+             strcmp(args[1], "delete") == 0) {
+    int id = s_sem_open(args[2]);
+    if (id == -1) {
+      res = -1;
+    } else if (args[1][0] == 'p') {
+      res = s_sem_post(id);
+    } else if (args[1][0] == 'w') {
+      res = s_sem_wait(id);
+    } else {
+      res = s_sem_destroy(id);
+    }
+  } else {
+    P_ERRNO = EARG;
+    res = -1;
+  }
+  if (res < 0) {
+    u_error("sem");
+  }
+  s_exit();
+  return NULL;
+}
+
+void* syncstat(void* arg) {
+  s_syncstat();
+  s_exit();
+  return NULL;
+}
+
+// Shared by the semstress workers, which only touch them under the mutex
+// except for the counts of contended and spinning
+static int stress_count;
+static int stress_contended;
+static int stress_spin_quanta;
+
+// Takes the semstress mutex iters times, each time holding it across a tick
+// so that the other workers find it locked
+static void* semstress_worker(void* arg) {
+  char** args = (char**)arg;
+  int iters = atoi(args[2]);
+  bool spin = strcmp(args[3], "spin") == 0;
+  volatile int* clock = &ticks;
+  int mutex = s_mutex_open("semstress");
+  for (int i = 0; i < iters; i++) {
+    if (s_mutex_trylock(mutex) == 1) {
+      stress_contended++;
+      if (spin) {
+        // retry until it is free, burning every quantum the lock is held
+        int seen = *clock;
+        while (s_mutex_trylock(mutex) == 1) {
+          if (*clock != seen) {
+            seen = *clock;
+            stress_spin_quanta++;
+          }
+        }
+      } else {
+        s_mutex_lock(mutex);
+      }
+    }
+    int count = stress_count;
+    for (int start = *clock; *clock == start;) {
+    }
+    stress_count = count + 1;
+    s_mutex_unlock(mutex);
+  }
+  s_exit();
+  return NULL;
+}
+
+/**
+ * @brief Contention benchmark: procs processes take a mutex iters times
+ * each, holding it across a tick every time, either blocking in
+ * s_mutex_lock (block, the default) or retrying s_mutex_trylock (spin).
+ * Prints the ticks it took, how many acquisitions found the mutex held and
+ * how many quanta the spinners burned.
+ *
+ * Example Usage: semstress 4 5
+ * Example Usage: semstress 4 5 spin
+ */
+void* semstress(void* arg) {
+  char** args = (char**)arg;
+  int procs = args[1] != NULL ? atoi(args[1]) : 0;
+  int iters = procs > 0 && args[2] != NULL ? atoi(args[2]) : 0;
+  char* mode = args[2] != NULL && args[3] != NULL ? args[3] : "block";
+  if (procs <= 0 || iters <= 0 ||
+      (strcmp(mode, "block") != 0 && strcmp(mode, "spin") != 0)) {
+    P_ERRNO = EARG;
+    u_error("semstress");
+    s_exit();
+    return NULL;
+  }
+  int mutex = s_mutex_create("semstress", false);
+  if (mutex == -1) {
+    u_error("semstress");
+    s_exit();
+    return NULL;
+  }
+  stress_count = 0;
+  stress_contended = 0;
+  stress_spin_quanta = 0;
+  int start = ticks;
+  char* worker_argv[] = {"semstress", args[1], args[2], mode, NULL};
+  int spawned = 0;
+  for (; spawned < procs; spawned++) {
+    if (s_spawn(semstress_worker, worker_argv, 0, 1, "semstress", false,
+                NULL) == -1) {
+      u_error("semstress");
+      break;
+    }
+  }
+  while (s_waitpid(-1, NULL, false) > 0) {
+  }
+  s_mutex_destroy(mutex);
+
+  pcb* proc = PCBDequeJobSearch(PCBList, currentJob);
+  char message[160];
+  snprintf(message, sizeof(message),
+           "%s: count %d/%d in %d ticks, %d contended, %d quanta spinning\n",
+           mode, stress_count, spawned * iters, ticks - start,
+           stress_contended, stress_spin_quanta);
+  s_write(proc->process_fdt[1], message, strlen(message));
+  s_exit();
+  return NULL;
+}
+
+/**
+ * @brief Creates or deletes a named shared-memory segment. A deleted segment
+ * is freed once the last process that has it mapped unmaps it.
+ *
+ * Example Usage: shm create frames 65536
+ * Example Usage: shm delete frames
+ */
+void* shm(void* arg) {
+  char** args = (char**)arg;
+  int res;
+  if (args[1] == NULL || args[2] == NULL) {
+    P_ERRNO = EARG;
+    res = -1;
+  } else if (strcmp(args[1], "create") == 0 && args[3] != NULL &&
+             atoi(args[3]) > 0) {
+    res = s_shm_open(args[2], atoi(args[3]), true);
+  } else if (strcmp(args[1], "delete") == 0) {
+    res = s_shm_unlink(args[2]);
+  } else {
+    P_ERRNO = EARG;
+    res = -1;
+  }
+  if (res < 0) {
+    u_error("shm");
+  }
+  s_exit();
+  return NULL;
+}
+
+void* shmstat(void* arg) {
+  s_shmstat();
+  s_exit();
+  return NULL;
+}
+
+#define SHMFAN_MAX_READERS 64
+
+// Sums a buffer as 64-bit words
+static uint64_t checksum(const uint64_t* words, size_t n) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < n; i++) {
+    sum += words[i] ^ i;
+  }
+  return sum;
+}
+
+// Maps the shmfan segment, sums the buffer at its start and stores the sum
+// in its slot after the buffer
+static void* shmfan_reader(void* arg) {
+  char** args = (char**)arg;
+  size_t words = (size_t)atoi(args[2]) * 1024 / sizeof(uint64_t);
+  int slot = atoi(args[3]);
+  int id = s_shm_open("shmfan", 0, false);
+  uint64_t* buf = id != -1 ? s_shm_map(id, NULL) : NULL;
+  if (buf == NULL) {
+    u_error("shmfan");
+    s_exit();
+    return NULL;
+  }
+  buf[words + slot] = checksum(buf, words);
+  s_shm_unmap(buf);
+  s_exit();
+  return NULL;
+}
+
+/**
+ * @brief Shared-memory fan-out: fills a buffer of kb KB in a shared segment
+ * and has procs processes map and checksum all of it, with no copy. Prints
+ * how many of them saw the buffer intact and how many ticks it took.
+ *
+ * Example Usage: shmfan 8 4096
+ */
+void* shmfan(void* arg) {
+  char** args = (char**)arg;
+  int procs = args[1] != NULL ? atoi(args[1]) : 0;
+  int kb = procs > 0 && args[2] != NULL ? atoi(args[2]) : 0;
+  size_t words = (size_t)kb * 1024 / sizeof(uint64_t);
+  size_t size = (words + procs) * sizeof(uint64_t);
+  if (procs <= 0 || procs > SHMFAN_MAX_READERS || kb <= 0 ||
+      size > SHM_SIZE_MAX) {
+    P_ERRNO = EARG;
+    u_error("shmfan");
+    s_exit();
+    return NULL;
+  }
+  int id = s_shm_open("shmfan", size, true);
+  uint64_t* buf = id != -1 ? s_shm_map(id, NULL) : NULL;
+  if (buf == NULL) {
+    u_error("shmfan");
+    s_exit();
+    return NULL;
+  }
+  for (size_t i = 0; i < words; i++) {
+    buf[i] = i * 0x9E3779B97F4A7C15ULL;
+  }
+  uint64_t expected = checksum(buf, words);
+
+  int start = ticks;
+  char slots[SHMFAN_MAX_READERS][12];
+  char* reader_argv[SHMFAN_MAX_READERS][5];
+  int spawned = 0;
+  for (; spawned < procs; spawned++) {
+    snprintf(slots[spawned], sizeof(slots[spawned]), "%d", spawned);
+    char** argv = reader_argv[spawned];
+    argv[0] = "shmfan";
+    argv[1] = args[1];
+    argv[2] = args[2];
+    argv[3] = slots[spawned];
+    argv[4] = NULL;
+    if (s_spawn(shmfan_reader, argv, 0, 1, "shmfan", false, NULL) == -1) {
+      u_error("shmfan");
+      break;
+    }
+  }
+  while (s_waitpid(-1, NULL, false) > 0) {
+  }
+  s_shm_unlink("shmfan");
+  int matched = 0;
+  for (int i = 0; i < spawned; i++) {
+    matched += buf[words + i] == expected;
+  }
+  s_shm_unmap(buf);
+
+  pcb* proc = PCBDequeJobSearch(PCBList, currentJob);
+  char message[128];
+  snprintf(message, sizeof(message),
+           "%d/%d readers saw all %d KB in %d ticks\n", matched, procs, kb,
+           ticks - start);
+  s_write(proc->process_fdt[1], message, strlen(message));
+  s_exit();
+  return NULL;
+}
+
+#define MQ_POLL_MAX 16
+
+// mq poll: waits up to ticks ticks (-1 for no limit) for a message on any of
+// the named queues, or for a line on stdin for "-", and prints one from each
+// that is ready
+static int mq_poll(pcb* proc, char* timeout, char** names) {
+  p_pollfd fds[MQ_POLL_MAX];
+  int nfds = 0;
+  for (; names[nfds] != NULL; nfds++) {
+    if (nfds == MQ_POLL_MAX) {
+      P_ERRNO = EARG;
+      return -1;
+    }
+    if (strcmp(names[nfds], "-") == 0) {
+      fds[nfds] = (p_pollfd){.fd = STDIN_FILENO, .events = P_POLLIN};
+    } else {
+      int id = s_mq_open(names[nfds], 0, false);
+      if (id == -1) {
+        return -1;
+      }
+      fds[nfds] = (p_pollfd){.fd = id, .events = P_POLLIN | P_POLLMQ};
+    }
+  }
+  int ready = s_poll(fds, nfds, atoi(timeout));
+  if (ready == 0) {
+    char* message = "timeout\n";
+    s_write(proc->process_fdt[1], message, strlen(message));
+  }
+  for (int i = 0; i < nfds && ready > 0; i++) {
+    if (!(fds[i].revents & P_POLLIN)) {
+      continue;
+    }
+    char message[MQ_MSG_MAX + 1];
+    int len;
+    if (fds[i].events & P_POLLMQ) {
+      mq_msg msg = {.data = message, .len = MQ_MSG_MAX};
+      len = s_mq_recv_batch(fds[i].fd, &msg, 1, true) == 1 ? msg.len : 0;
+    } else {
+      len = s_read(fds[i].fd, MQ_MSG_MAX, message);
+      len = len > 0 && message[len - 1] == '\n' ? len - 1 : len;
+    }
+    char line[MQ_MSG_MAX + MQ_NAME_MAX + 4];
+    int n = snprintf(line, sizeof(line), "%s: %.*s\n", names[i],
+                     len > 0 ? len : 0, message);
+    s_write(proc->process_fdt[1], line, n);
+  }
+  return ready;
+}
+
+/**
+ * @brief Creates, sends to, receives from, polls or deletes named message
+ * queues. recv blocks the process until a message arrives and prints it;
+ * send blocks while the queue is full. poll waits for the first of several
+ * queues (or stdin, named -) to have input, for at most ticks ticks (-1 for
+ * no limit), and prints a message from each that does.
+ *
+ * Example Usage: mq create requests 128 (holds up to 128 messages)
+ * Example Usage: mq recv requests &
+ * Example Usage: mq send requests hello world
+ * Example Usage: mq poll 50 requests replies -
+ * Example Usage: mq delete requests
+ */
+void* mq(void* arg) {
+  char** args = (char**)arg;
+  pcb* proc = PCBDequeJobSearch(PCBList, currentJob);
+  int res = -1;
+  int id = -1;
+  if (args[1] == NULL || args[2] == NULL) {
+    P_ERRNO = EARG;
+  } else if (strcmp(args[1], "poll") == 0 && args[3] != NULL) {
+    res = mq_poll(proc, args[2], args + 3);
+  } else if (strcmp(args[1], "create") == 0) {
+    res = s_mq_open(args[2], args[3] != NULL ? atoi(args[3]) : 0, true);
+  } else if ((id = s_mq_open(args[2], 0, false)) == -1) {
+    res = -1;
+  } else if (strcmp(args[1], "send") == 0) {
+    char message[MQ_MSG_MAX + 1] = "";
+    for (int i = 3; args[i] != NULL; i++) {
+      if (i > 3) {
+        strncat(message, " ", MQ_MSG_MAX - strlen(message));
+      }
+      strncat(message, args[i], MQ_MSG_MAX - strlen(message));
+    }
+    res = s_mq_send(id, message, strlen(message));
+  } else if (strcmp(args[1], "recv") == 0) {
+    char message[MQ_MSG_MAX + 1];
+    res = s_mq_recv(id, message, MQ_MSG_MAX);
+    if (res >= 0) {
+      message[res++] = '\n';
+      s_write(proc->process_fdt[1], message, res);
+    }
+  } else if (strcmp(args[1], "delete") == 0) {
+    res = s_mq_destroy(id);
+  } else {
+    P_ERRNO = EARG;
+  }
+  if (res < 0) {
+    u_error("mq");
+  }
+  s_exit();
+  return NULL;
+}
+
+void* mqstat(void* arg) {
+  s_mqstat();
+  s_exit();
+  return NULL;
+}
+
 /**
  * @brief Lists all available commands.
  *
@@ -716,19 +1223,25 @@ void* man(void* arg) {
 
   char message[100];
 
-  sprintf(message, "bg: Resumes a process that is in the background\n");
+  sprintf(message, "aging ticks [max] | off: Boosts jobs that wait too long\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "bg [%%n]: Resumes a stopped job in the background\n");
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "busy: Busy waits indefinitely\n");
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "cat: Concatenate files and print to stdout\n");
   s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "cgroup create|set|add|delete: Manages CPU groups\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "cgstat: Displays CPU group shares, quotas and usage\n");
+  s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "chmod: Change file permissions for a file\n");
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "cp: Copies a file\n");
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "echo: Echo back an input string provided\n");
   s_write(output_fd, message, strlen(message) + 1);
-  sprintf(message, "fg: Bring a process to the foreground and resumes it\n");
+  sprintf(message, "fg [%%n]: Brings a job to the foreground and resumes it\n");
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "jobs: Lists all jobs which are running\n");
   s_write(output_fd, message, strlen(message) + 1);
@@ -740,6 +1253,10 @@ void* man(void* arg) {
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "man: Displays the man pages\n");
   s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "mq create|send|recv|poll|delete: Uses message queues\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "mqstat: Displays message queues and their traffic\n");
+  s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "mv: Renames a file\n");
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "nice: Spawns a new process for and set its priority\n");
@@ -752,8 +1269,24 @@ void* man(void* arg) {
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "rm: Removes a list of files\n");
   s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "rt_pid period budget pid: Makes a process real-time\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "shm create|delete: Manages shared-memory segments\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "shmfan procs kb: Shares a buffer between processes\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "shmstat: Displays shared-memory segments\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "schedstat: Displays scheduling latency statistics\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "sem create|post|wait|delete: Manages semaphores\n");
+  s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "semstress n iters [spin]: Mutex contention benchmark\n");
+  s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "sleep: Sleeps for x amount of time\n");
   s_write(output_fd, message, strlen(message) + 1);
+  sprintf(message, "syncstat: Displays semaphores and mutexes\n");
+  s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "touch: Creates a new file\n");
   s_write(output_fd, message, strlen(message) + 1);
   sprintf(message, "zombify: Creates a zombied process\n");
@@ -761,22 +1294,27 @@ void* man(void* arg) {
   return NULL;
 }
 
+// Parses a job argument of the form %n or n, -1 if there is none
+static int parse_job_id(char* job_arg) {
+  if (job_arg == NULL) {
+    return -1;
+  }
+  if (job_arg[0] == '%') {
+    job_arg++;
+  }
+  int job_id = atoi(job_arg);
+  return job_id > 0 ? job_id : 0;
+}
+
 /**
  * @brief Resumes the most recently stopped job in the background, or the job
  * specified by job_id.
  *
  * Example Usage: bg
- * Example Usage: bg 2 (job_id is 2)
+ * Example Usage: bg %2 (job_id is 2)
  */
 void* bg(void* arg) {
-  char* job_arg = ((char**)arg)[1];
-  pid_t pid;
-  if (job_arg == NULL) {
-    pid = -1;
-  } else {
-    pid = atoi(job_arg);
-  }
-  int res = s_handle_bg(pid);
+  int res = s_handle_bg(parse_job_id(((char**)arg)[1]));
   if (res == -1) {
     P_ERRNO = EJOB;
     u_error("bg");
@@ -790,22 +1328,15 @@ void* bg(void* arg) {
  * or the job specified by job_id.
  *
  * Example Usage: fg
- * Example Usage: fg 2 (job_id is 2)
+ * Example Usage: fg %2 (job_id is 2)
  */
 void* fg(void* arg) {
-  char* job_arg = ((char**)arg)[1];
-  pid_t pid;
-  if (job_arg == NULL) {
-    pid = -1;
-  } else {
-    pid = atoi(job_arg);
-  }
-  int res = s_handle_fg(pid);
+  int res = s_handle_fg(parse_job_id(((char**)arg)[1]));
   pcb* curr_job = PCBDequeJobSearch(PCBList, currentJob);
   spthread_suspend(curr_job->curr_thread);
   if (res == -1) {
     P_ERRNO = EJOB;
-    u_error("bg");
+    u_error("fg");
     return NULL;
   }
   return NULL;
@@ -820,28 +1351,7 @@ void* jobs(void* arg) {
   if (PCBList == NULL) {
     return NULL;
   }
-
-  int output_fd = (int)(intptr_t)arg;
-
-  PCBDqNode* dq_node = PCBList->front;
-  while (dq_node != NULL) {
-    // Skip if it is the shell process
-    if (dq_node->pcb->pid == 1 || dq_node->pcb->parent_pid != 1) {
-      dq_node = dq_node->next;
-      continue;
-    }
-    char* status = (dq_node->pcb)->status == STATUS_RUNNING    ? "running"
-                   : (dq_node->pcb)->status == STATUS_STOPPED  ? "stopped"
-                   : (dq_node->pcb)->status == STATUS_BLOCKED  ? "blocked"
-                   : (dq_node->pcb)->status == STATUS_FINISHED ? "finished"
-                                                               : "terminated";
-    char message[100];
-    char plus = ((dq_node->pcb)->pid == plus_pid) ? '+' : ' ';
-    sprintf(message, "[%d]%c %s (%s)\n", (dq_node->pcb)->job_id, plus,
-            (dq_node->pcb)->process_name, status);
-    s_write(output_fd, message, strlen(message) + 1);
-    dq_node = dq_node->next;
-  }
+  s_jobs((int)(intptr_t)arg);
   return NULL;
 }
 /**
@@ -129,6 +129,21 @@ void* chmod(void* arg);
  */
 void* ps(void* arg);
 
+/**
+ * @brief Display dispatch latency percentiles for each priority level,
+ * measured from when a job becomes runnable until it is scheduled.
+ *
+ * Example Usage: schedstat
+ */
+void* schedstat(void* arg);
+
+/**
+ * @brief Display the shares, quota and CPU usage of every CPU group.
+ *
+ * Example Usage: cgstat
+ */
+void* cgstat(void* arg);
+
 /**
  * @brief Sends a specified signal to a list of processes.
  * If a signal name is not specified, default to "term".
@@ -138,6 +153,7 @@ void* ps(void* arg);
  * Example Usage: kill -term 1 2 (sends term to processes 1 and 2)
  * Example Usage: kill -stop 1 2 (sends stop to processes 1 and 2)
  * Example Usage: kill -cont 1 (sends cont to process 1)
+ * Example Usage: kill -stop -4 (sends stop to every process in group 4)
  */
 void* os_kill(void* arg);
 
@@ -146,7 +162,7 @@ void* os_kill(void* arg);
  * or the job specified by job_id.
  *
  * Example Usage: fg
- * Example Usage: fg 2 (job_id is 2)
+ * Example Usage: fg %2 (job_id is 2)
  */
 void* fg(void* arg);
 
@@ -155,7 +171,7 @@ void* fg(void* arg);
  * specified by job_id.
  *
  * Example Usage: bg
- * Example Usage: bg 2 (job_id is 2)
+ * Example Usage: bg %2 (job_id is 2)
  */
 void* bg(void* arg);
 
@@ -174,6 +190,106 @@ void* u_nice(void* arg);
  */
 void* nice_pid(void* arg);
 
+/**
+ * @brief Puts an existing process in the real-time class, running it for
+ * budget ticks every period ticks, or takes it out with 0 0.
+ *
+ * Example Usage: rt_pid 10 2 123 (PID 123 runs 2 ticks in every 10)
+ */
+void* rt_pid(void* arg);
+
+/**
+ * @brief Creates, configures or destroys CPU groups and moves processes into
+ * them.
+ *
+ * Example Usage: cgroup create tenant1 (a group under the root)
+ * Example Usage: cgroup set tenant1 2048 5 10 (double shares, 5 ticks in 10)
+ * Example Usage: cgroup add tenant1 123 (moves PID 123 into tenant1)
+ * Example Usage: cgroup delete tenant1
+ */
+void* cgroup(void* arg);
+
+/**
+ * @brief Turns anti-starvation aging on or off. Jobs which wait `ticks` ticks
+ * in their queue are boosted one level, up to `max_boost` (default 2) levels.
+ *
+ * Example Usage: aging 20 (boost after 20 ticks of waiting)
+ * Example Usage: aging 20 1 (never boost by more than one level)
+ * Example Usage: aging off
+ */
+void* aging(void* arg);
+
+/**
+ * @brief Creates, posts, waits on or deletes a named semaphore. wait blocks
+ * the process until a post hands it a unit. -p wakes waiters by priority
+ * instead of in arrival order.
+ *
+ * Example Usage: sem create slots 4 -p (count 4, waiters woken by priority)
+ * Example Usage: sem wait items &
+ * Example Usage: sem post items
+ * Example Usage: sem delete items
+ */
+void* sem(void* arg);
+
+/**
+ * @brief Lists the semaphores and mutexes with their counts or owners,
+ * waiters and contention.
+ *
+ * Example Usage: syncstat
+ */
+void* syncstat(void* arg);
+
+/**
+ * @brief Contention benchmark: procs processes take a mutex iters times
+ * each, holding it across a tick, blocking on it or, with spin, retrying.
+ *
+ * Example Usage: semstress 4 5 spin
+ */
+void* semstress(void* arg);
+
+/**
+ * @brief Creates or deletes a named shared-memory segment.
+ *
+ * Example Usage: shm create frames 65536
+ * Example Usage: shm delete frames
+ */
+void* shm(void* arg);
+
+/**
+ * @brief Lists the shared-memory segments with their sizes and mappings.
+ *
+ * Example Usage: shmstat
+ */
+void* shmstat(void* arg);
+
+/**
+ * @brief Shared-memory fan-out: fills a buffer of kb KB in a shared segment
+ * and has procs processes map and checksum all of it.
+ *
+ * Example Usage: shmfan 8 4096
+ */
+void* shmfan(void* arg);
+
+/**
+ * @brief Creates, sends to, receives from, polls or deletes named message
+ * queues. recv blocks until a message arrives and prints it; poll waits for
+ * the first of several queues (or stdin, named -) to have one.
+ *
+ * Example Usage: mq create requests 128 (holds up to 128 messages)
+ * Example Usage: mq recv requests &
+ * Example Usage: mq send requests hello world
+ * Example Usage: mq poll 50 requests replies - (waits at most 50 ticks)
+ * Example Usage: mq delete requests
+ */
+void* mq(void* arg);
+
+/**
+ * @brief Lists the message queues with their capacity, backlog and traffic.
+ *
+ * Example Usage: mqstat
+ */
+void* mqstat(void* arg);
+
 /**
  * @brief Helper for zombify.
  */
@@ -18,7 +18,6 @@ extern int logfd;
 
 extern bool logged_out;
 
-extern int num_bg_jobs;
 
 extern pid_t plus_pid;
 
@@ -4,6 +4,11 @@
 #define P_SIGCONT 70
 #define P_SIGTERM 71
 
+// PRIORITY MACROS
+#define MAX_PRIORITY_LEVELS 8  // most priority levels that can be set at boot
+#define INACTIVE_QUEUE MAX_PRIORITY_LEVELS  // priorityList index of the queue
+                                            // of blocked and stopped jobs
+
 // STATUS MACROS
 #define STATUS_RUNNING 100
 #define STATUS_STOPPED 101
@@ -15,4 +20,4 @@
 #define P_WIFSTOPPED(status) (status == STATUS_STOPPED ? 1 : 0)
 #define P_WIFBLOCKED(status) (status == STATUS_BLOCKED ? 1 : 0)
 #define P_WIFEXITED(status) (status == STATUS_FINISHED ? 1 : 0)
-#define P_WIFSIGNALED(status) (status == STATUS_TERMINATED ? 1 : 0)
\ No newline at end of file
+#define P_WIFSIGNALED(status) (status == STATUS_TERMINATED ? 1 : 0)
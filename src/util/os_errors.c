@@ -26,6 +26,22 @@ const char* str_error(int errnum) {
       return "Host OS error";
     case EJOB:
       return "Invalid job / job doesn't exist";
+    case EPGRP:
+      return "No such process group";
+    case ERTCAP:
+      return "Not enough real-time capacity";
+    case ECGROUP:
+      return "No such CPU group, or it is not empty";
+    case EPIDS:
+      return "No free process IDs";
+    case ESYNC:
+      return "No such semaphore or mutex, or it is in use";
+    case ESHM:
+      return "No such shared memory segment";
+    case EMQ:
+      return "No such message queue, or it has waiters";
+    case EAIO:
+      return "No such I/O ticket, or too many operations in flight";
     default:
       return "Unknown error";
   }
@@ -17,6 +17,14 @@ extern int P_ERRNO;
 #define ECMD 10   // Invalid command
 #define EHOST 11  // Host OS error
 #define EJOB 12   // Invalid job / job doesn't exist
+#define EPGRP 13  // No such process group
+#define ERTCAP 14  // Not enough real-time capacity
+#define ECGROUP 15  // No such CPU group, or it is not empty
+#define EPIDS 16  // No free process IDs
+#define ESYNC 17  // No such semaphore or mutex, or it is in use
+#define ESHM 18  // No such shared memory segment
+#define EMQ 19  // No such message queue, or it has waiters
+#define EAIO 20  // No such I/O ticket, or too many operations in flight
 
 /**
  * @brief User function to write an error message
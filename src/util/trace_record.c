@@ -0,0 +1,47 @@
+#include "trace_record.h"
+#include <stdio.h>
+#include <string.h>
+
+// Labels as they appear in the text log, padded to the same width
+static const char* labels[TRACE_NUM_TYPES] = {
+    "CREATE   ", "SCHEDULE ", "BLOCKED  ", "UNBLOCKED", "EXITED   ",
+    "ZOMBIE   ", "ORPHAN   ", "WAITED   ", "SIGNALED ", "STOPPED  ",
+    "CONTINUED", "NICE     ", "",          "",          "MISSED   ",
+    "DROPPED  ",
+};
+
+const char* trace_label(int type) {
+  if (type < 0 || type >= TRACE_NUM_TYPES) {
+    return "";
+  }
+  return labels[type];
+}
+
+int trace_format(const trace_record* rec, char* buf, size_t size) {
+  if (rec->type < 0 || rec->type >= TRACE_NUM_TYPES ||
+      rec->type == TRACE_RUNQUEUE) {
+    buf[0] = '\0';
+    return 0;
+  }
+
+  char name[TRACE_NAME_SIZE + 1];
+  memcpy(name, rec->name, TRACE_NAME_SIZE);
+  name[TRACE_NAME_SIZE] = '\0';
+
+  int len;
+  if (rec->type == TRACE_TEXT) {
+    int n = rec->arg < TRACE_NAME_SIZE ? rec->arg : TRACE_NAME_SIZE;
+    len = snprintf(buf, size, "%.*s", n, name);
+  } else if (rec->type == TRACE_NICE || rec->type == TRACE_MISSED ||
+             rec->type == TRACE_DROPPED) {
+    len = snprintf(buf, size, "[%3d]\t%s\t%d\t%d\t%d\t%-15s\n", rec->tick,
+                   labels[rec->type], rec->pid, rec->priority, rec->arg, name);
+  } else {
+    len = snprintf(buf, size, "[%3d]\t%s\t%d\t%d\t%-15s\n", rec->tick,
+                   labels[rec->type], rec->pid, rec->priority, name);
+  }
+  if (len < 0) {
+    return 0;
+  }
+  return (size_t)len < size ? len : (int)size - 1;
+}
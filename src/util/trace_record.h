@@ -0,0 +1,76 @@
+#ifndef TRACE_RECORD_H_
+#define TRACE_RECORD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// On-disk format of the PennOS log. The log file starts with a
+// trace_file_header followed by fixed-size trace_records. bin/pennlog decodes
+// the records back into the text log format.
+///////////////////////////////////////////////////////////////////////////////
+
+#define TRACE_MAGIC "PENNTRC1"
+#define TRACE_VERSION 1
+#define TRACE_NAME_SIZE 40
+
+// Event types. Each maps to one of the labels in the text log.
+#define TRACE_CREATE 0
+#define TRACE_SCHEDULE 1
+#define TRACE_BLOCKED 2
+#define TRACE_UNBLOCKED 3
+#define TRACE_EXITED 4
+#define TRACE_ZOMBIE 5
+#define TRACE_ORPHAN 6
+#define TRACE_WAITED 7
+#define TRACE_SIGNALED 8
+#define TRACE_STOPPED 9
+#define TRACE_CONTINUED 10
+#define TRACE_NICE 11
+#define TRACE_TEXT 12  // free-form text, `name` holds a chunk of the message
+#define TRACE_RUNQUEUE 13  // depth (arg) of the runnable queue for priority,
+                           // not part of the text log
+#define TRACE_MISSED 14    // a real-time job missed the deadline in arg
+#define TRACE_DROPPED 15   // arg records were lost because the ring was full
+#define TRACE_NUM_TYPES 16
+
+typedef struct trace_file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+} trace_file_header;
+
+// A single event, sized to fill one cache line
+typedef struct trace_record {
+  uint64_t ns;       // host monotonic time of the event
+  int32_t tick;      // PennOS clock tick
+  int32_t pid;       // process the event is about
+  int16_t type;      // one of the TRACE_* event types
+  int16_t priority;  // priority of the process (old priority for NICE)
+  int32_t arg;       // event specific: new priority for NICE, text length for
+                     // TRACE_TEXT, queue depth for TRACE_RUNQUEUE, deadline
+                     // tick for MISSED, records lost for DROPPED
+  char name[TRACE_NAME_SIZE];  // process name, not necessarily terminated
+} trace_record;
+
+/**
+ * @brief Formats a record exactly as the text log line for that event would
+ * have been written. Records with no text form (TRACE_RUNQUEUE) format to an
+ * empty string.
+ *
+ * @param rec the record to format
+ * @param buf output buffer
+ * @param size size of the output buffer
+ * @return number of characters written to buf (excluding the terminator)
+ */
+int trace_format(const trace_record* rec, char* buf, size_t size);
+
+/**
+ * @brief Returns the text log label of an event type (e.g. "SCHEDULE ").
+ *
+ * @param type one of the TRACE_* event types
+ * @return the label, or an empty string for types with no text form
+ */
+const char* trace_label(int type);
+
+#endif  // TRACE_RECORD_H_